@@ -1,11 +1,22 @@
 #include <chrono>   // Для замеров времени
+#include <cstdio>
+#include <filesystem>
+#include <functional>
 #include <iomanip>  // Для красивого вывода (setw)
 #include <iostream>
 #include <memory>
+#include <random>
+#include <string>
 #include <vector>
 
+#include "src/AutoTuner.hpp"
+#include "src/Heston.hpp"
+#include "src/HestonEngine.hpp"
+#include "src/JumpDiffusion.hpp"
 #include "src/MCEngine.hpp"
+#include "src/NormalGenerator.hpp"
 #include "src/Payoff.hpp"
+#include "src/VariateBank.hpp"
 
 // Константы для теста
 const double S0 = 100.0;
@@ -64,6 +75,261 @@ int main() {
                   << std::setprecision(2) << speedup << "x" << std::endl;
     }
 
+    // Сравнение точности: double vs float на всех потоках
+    std::cout << "\n=== Precision: double vs float (" << maxThreads << " threads) ===" << std::endl;
+    std::cout << std::left << std::setw(12) << "Product" << std::setw(10) << "Precision"
+              << std::setw(15) << "Time (sec)" << std::setw(15) << "Price" << std::setw(10)
+              << "Speedup" << std::endl;
+    std::cout << std::string(62, '-') << std::endl;
+
+    auto asianPayoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine asianEngine(asianPayoff, S0, T, r, sigma, 12345);
+    asianEngine.setNumThreads(maxThreads);
+    engine.setNumThreads(maxThreads);
+
+    struct Product {
+        const char* name;
+        mcopt::MonteCarloEngine* engine;
+        bool asian;
+    };
+    for (const Product& product : {Product{"European", &engine, false},
+                                   Product{"Asian", &asianEngine, true}}) {
+        double doubleTime = 0.0;
+        for (mcopt::Precision precision : {mcopt::Precision::Double, mcopt::Precision::Single}) {
+            product.engine->setPrecision(precision);
+            auto start = std::chrono::high_resolution_clock::now();
+            double price = product.asian ? product.engine->calculateAsianPrice(NUM_PATHS / 50, 252)
+                                         : product.engine->calculatePrice(NUM_PATHS);
+            std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - start;
+            if (precision == mcopt::Precision::Double) doubleTime = diff.count();
+
+            std::cout << std::left << std::setw(12) << product.name << std::setw(10)
+                      << (precision == mcopt::Precision::Double ? "double" : "float")
+                      << std::setw(15) << std::fixed << std::setprecision(4) << diff.count()
+                      << std::setw(15) << std::setprecision(5) << price << std::setw(10)
+                      << std::setprecision(2) << doubleTime / diff.count() << "x" << std::endl;
+        }
+    }
+
+    // Эффективность схем выборки: дисперсия x время (меньше — лучше), выигрыш относительно
+    // обычного MC (европейский — антитетические пары, азиатский — независимые пути)
+    std::cout << "\n=== Sampling schemes: variance x time (" << maxThreads << " threads) ==="
+              << std::endl;
+    std::cout << std::left << std::setw(10) << "Product" << std::setw(22) << "Scheme"
+              << std::setw(12) << "Time (sec)" << std::setw(12) << "Price" << std::setw(12)
+              << "Std Error" << std::setw(10) << "Gain" << std::endl;
+    std::cout << std::string(78, '-') << std::endl;
+
+    engine.setPrecision(mcopt::Precision::Double);
+    asianEngine.setPrecision(mcopt::Precision::Double);
+    const unsigned long long schemePaths = NUM_PATHS / 10;
+    const unsigned int asianSteps = 64;
+
+    struct Scheme {
+        const char* name;
+        std::function<mcopt::PricingResult(const mcopt::MonteCarloEngine&, unsigned int)> run;
+    };
+    const std::vector<Scheme> schemes = {
+        {"Plain",
+         [&](const mcopt::MonteCarloEngine& e, unsigned int steps) {
+             return steps == 0 ? e.calculateSpotLadder({S0}, schemePaths).front()
+                               : e.calculateAsianPriceAsync(schemePaths, steps).get();
+         }},
+        {"Stratified (prop.)",
+         [&](const mcopt::MonteCarloEngine& e, unsigned int steps) {
+             return e.calculateStratifiedPrice(schemePaths, steps, 256);
+         }},
+        {"Stratified (Neyman)",
+         [&](const mcopt::MonteCarloEngine& e, unsigned int steps) {
+             return e.calculateStratifiedPrice(schemePaths, steps, 256, mcopt::Allocation::Neyman);
+         }},
+        {"Latin hypercube",
+         [&](const mcopt::MonteCarloEngine& e, unsigned int steps) {
+             return e.calculateLatinHypercubePrice(schemePaths, steps);
+         }},
+    };
+    for (const Product& product : {Product{"European", &engine, false},
+                                   Product{"Asian", &asianEngine, true}}) {
+        double plainCost = 0.0;
+        for (const Scheme& scheme : schemes) {
+            auto start = std::chrono::high_resolution_clock::now();
+            mcopt::PricingResult result =
+                scheme.run(*product.engine, product.asian ? asianSteps : 0);
+            std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - start;
+            double cost = result.standardError * result.standardError * diff.count();
+            if (plainCost == 0.0) plainCost = cost;
+
+            std::cout << std::left << std::setw(10) << product.name << std::setw(22) << scheme.name
+                      << std::setw(12) << std::fixed << std::setprecision(4) << diff.count()
+                      << std::setw(12) << std::setprecision(5) << result.price << std::setw(12)
+                      << std::setprecision(6) << result.standardError << std::setw(10)
+                      << std::setprecision(2) << plainCost / cost << "x" << std::endl;
+        }
+    }
+
+    // Скачкообразная диффузия Мертона против GBM на тех же путях (время на путь)
+    std::cout << "\n=== Merton jump-diffusion vs GBM (" << maxThreads << " threads) ==="
+              << std::endl;
+    std::cout << std::left << std::setw(10) << "Product" << std::setw(12) << "GBM (sec)"
+              << std::setw(15) << "Merton (sec)" << std::setw(10) << "Ratio" << std::endl;
+    std::cout << std::string(47, '-') << std::endl;
+
+    const mcopt::MertonParameters jumps{1.0, -0.2, 0.15};
+    mcopt::JumpDiffusionEngine europeanJumps(payoff, S0, T, r, sigma, jumps, 12345);
+    mcopt::JumpDiffusionEngine asianJumps(asianPayoff, S0, T, r, sigma, jumps, 12345);
+    auto timeIt = [](auto&& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - start;
+        return diff.count();
+    };
+    for (bool asian : {false, true}) {
+        const unsigned long long paths = asian ? schemePaths : NUM_PATHS;
+        double gbm = timeIt([&] {
+            if (asian) {
+                static_cast<void>(asianEngine.calculateAsianPrice(paths, asianSteps));
+            } else {
+                static_cast<void>(engine.calculatePrice(paths));
+            }
+        });
+        double merton = timeIt([&] {
+            if (asian) {
+                static_cast<void>(asianJumps.calculateAsianPrice(paths, asianSteps, false));
+            } else {
+                static_cast<void>(europeanJumps.calculatePrice(paths));
+            }
+        });
+        std::cout << std::left << std::setw(10) << (asian ? "Asian" : "European") << std::setw(12)
+                  << std::fixed << std::setprecision(4) << gbm << std::setw(15) << merton
+                  << std::setw(10) << std::setprecision(2) << merton / gbm << "x" << std::endl;
+    }
+
+    // Калибровка Хестона к синтетической поверхности 8 x 25 и переоценка методом Монте-Карло
+    std::cout << "\n=== Heston calibration (200 quotes) ===" << std::endl;
+    const mcopt::HestonParameters hestonTrue{0.04, 1.5, 0.06, 0.6, -0.7};
+    mcopt::HestonCOSPricer cos(S0, r);
+    std::vector<mcopt::HestonQuote> quotes;
+    for (double maturity : {0.1, 0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0}) {
+        for (int i = 0; i < 25; ++i) {
+            double strike = 60.0 + 3.75 * i;
+            auto type = (strike < S0) ? mcopt::OptionType::Put : mcopt::OptionType::Call;
+            double price = cos.price(hestonTrue, maturity, strike, type);
+            quotes.push_back({maturity, strike, price, type});
+        }
+    }
+    mcopt::HestonCalibrator calibrator(S0, r, quotes);
+    mcopt::HestonCalibration fit;
+    double calibrationTime =
+        timeIt([&] { fit = calibrator.calibrate({0.02, 3.0, 0.03, 0.3, -0.2}); });
+    std::cout << "Time: " << std::fixed << std::setprecision(4) << calibrationTime
+              << " sec, iterations: " << fit.iterations << ", RMSE: " << std::scientific
+              << std::setprecision(2) << fit.rmse << ", sub-second: "
+              << (calibrationTime < 1.0 ? "yes" : "NO") << std::endl;
+    mcopt::HestonEngine hestonEngine(payoff, S0, T, r, fit.parameters, 12345);
+    mcopt::PricingResult hestonMC;
+    double hestonTime = timeIt([&] { hestonMC = hestonEngine.calculatePrice(1'000'000, 64); });
+    std::cout << "MC (1M x 64, QE): " << std::fixed << std::setprecision(4) << hestonMC.price
+              << " +- " << hestonMC.standardError << " in " << hestonTime
+              << " sec, COS: " << cos.price(fit.parameters, T, K, mcopt::OptionType::Call)
+              << std::endl;
+
+    // Автонастройка: выбранный план и прогноз времени прогона (без пилота) против факта
+    std::cout << "\n=== Auto-tuned plans (target SE 0.002) ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "Product" << std::setw(16) << "Method"
+              << std::setw(8) << "Float" << std::setw(9) << "Threads" << std::setw(12) << "Paths"
+              << std::setw(12) << "Predicted" << std::setw(12) << "Actual" << std::setw(12)
+              << "Std Error" << std::endl;
+    std::cout << std::string(91, '-') << std::endl;
+
+    const char* methodNames[] = {"Antithetic", "Stratified", "Latin hypercube", "Importance"};
+    mcopt::AutoTuner tuner;
+    for (const Product& product : {Product{"European", &engine, false},
+                                   Product{"Asian", &asianEngine, true}}) {
+        mcopt::TunedResult tuned = tuner.price(*product.engine, product.asian ? asianSteps : 0,
+                                               0.002);
+        std::cout << std::left << std::setw(10) << product.name << std::setw(16)
+                  << methodNames[static_cast<int>(tuned.plan.method)] << std::setw(8)
+                  << (tuned.plan.precision == mcopt::Precision::Single ? "yes" : "no")
+                  << std::setw(9) << tuned.plan.threads << std::setw(12) << tuned.plan.paths
+                  << std::setw(12) << std::fixed << std::setprecision(4)
+                  << tuned.plan.predictedSeconds - tuned.plan.pilotSeconds << std::setw(12)
+                  << tuned.seconds << std::setw(12) << std::setprecision(6)
+                  << tuned.result.standardError << std::endl;
+    }
+
+    // Банк нормалей в отображаемом файле против живой генерации (цены совпадают побитово)
+    std::cout << "\n=== Variate bank vs live RNG (" << maxThreads << " threads) ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "Product" << std::setw(12) << "Bank (MB)"
+              << std::setw(12) << "Live (sec)" << std::setw(12) << "Bank (sec)" << std::setw(10)
+              << "Speedup" << std::setw(10) << "Same" << std::endl;
+    std::cout << std::string(66, '-') << std::endl;
+
+    const unsigned long long bankAsianPaths = schemePaths / 5;
+    for (const Product& product : {Product{"European", &engine, false},
+                                   Product{"Asian", &asianEngine, true}}) {
+        const unsigned long long paths = product.asian ? bankAsianPaths : NUM_PATHS;
+        const unsigned int steps = product.asian ? asianSteps : 0;
+        const std::string bankFile =
+            (std::filesystem::temp_directory_path() / "mcopt_benchmark_bank.bin").string();
+        mcopt::VariateBank::create(bankFile, 12345, product.engine->normalMethod(), paths, steps);
+        auto bank = std::make_shared<const mcopt::VariateBank>(bankFile);
+
+        auto run = [&] {
+            return product.asian ? product.engine->calculateAsianPrice(paths, steps)
+                                 : product.engine->calculatePrice(paths);
+        };
+        double livePrice = 0.0;
+        double bankPrice = 0.0;
+        double live = timeIt([&] { livePrice = run(); });
+        product.engine->setVariateBank(bank);
+        static_cast<void>(run());  // Прогрев страниц отображения
+        double banked = timeIt([&] { bankPrice = run(); });
+        product.engine->setVariateBank(nullptr);
+
+        const double megabytes = static_cast<double>(bank->blocks() * bank->variatesPerBlock()) *
+                                 sizeof(double) / 1e6;
+        std::cout << std::left << std::setw(10) << product.name << std::setw(12) << std::fixed
+                  << std::setprecision(1) << megabytes << std::setw(12) << std::setprecision(4)
+                  << live << std::setw(12) << banked << std::setw(10) << std::setprecision(2)
+                  << live / banked << std::setw(10) << (livePrice == bankPrice ? "yes" : "no")
+                  << std::endl;
+        bank.reset();
+        std::remove(bankFile.c_str());
+    }
+
+    // Микробенчмарк генераторов нормальных величин (один поток)
+    std::cout << "\n=== Normal variates (1 thread) ===" << std::endl;
+    std::cout << std::left << std::setw(25) << "Generator" << std::setw(15) << "Time (sec)"
+              << std::setw(15) << "M normals/s" << std::endl;
+    std::cout << std::string(55, '-') << std::endl;
+
+    const std::size_t numNormals = NUM_PATHS;
+    std::vector<double> normals(4096);
+    auto timeNormals = [&](const char* name, auto&& generate) {
+        std::mt19937_64 rng(12345);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t done = 0; done < numNormals; done += normals.size()) {
+            generate(rng);
+        }
+        std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - start;
+        std::cout << std::left << std::setw(25) << name << std::setw(15) << std::fixed
+                  << std::setprecision(4) << diff.count() << std::setw(15) << std::setprecision(1)
+                  << static_cast<double>(numNormals) / diff.count() / 1e6 << std::endl;
+    };
+
+    timeNormals("std::normal_distribution", [&](std::mt19937_64& rng) {
+        std::normal_distribution<double> dist(0.0, 1.0);
+        for (double& z : normals) z = dist(rng);
+    });
+    for (mcopt::NormalMethod method :
+         {mcopt::NormalMethod::Ziggurat, mcopt::NormalMethod::InverseCdf}) {
+        mcopt::NormalGenerator generator(method);
+        timeNormals(method == mcopt::NormalMethod::Ziggurat ? "Ziggurat" : "Inverse CDF (AS241)",
+                    [&](std::mt19937_64& rng) {
+                        generator.fill(rng, normals.data(), normals.size());
+                    });
+    }
+
     std::cout << "\nBenchmark finished." << std::endl;
     return 0;
 }
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "src/Sharding.hpp"
+
+// Процесс-воркер для распределенного расчета (SocketTransport)
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " [options]\n"
+              << "Options:\n"
+              << "  --port <value>      TCP port to listen on (default: 5050, 0 = any free port)\n"
+              << "  --bind <address>    IPv4 interface to listen on (default: 127.0.0.1;\n"
+              << "                      0.0.0.0 = all, no authentication: trusted networks only)\n"
+              << "  --threads <value>   Threads per shard (default: hardware concurrency)\n"
+              << "  --tasks <value>     Exit after this many shards (default: 0 = never)\n"
+              << "  --help              Show this help message\n";
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long port = 5050;
+    unsigned long threads = 0;
+    unsigned long long tasks = 0;
+    std::string bindAddress = "127.0.0.1";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        if (i + 1 < argc) {
+            try {
+                if (arg == "--port")
+                    port = std::stoul(argv[++i]);
+                else if (arg == "--bind")
+                    bindAddress = argv[++i];
+                else if (arg == "--threads")
+                    threads = std::stoul(argv[++i]);
+                else if (arg == "--tasks")
+                    tasks = std::stoull(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error parsing value for " << arg << ": " << e.what() << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    try {
+        mcopt::ShardWorkerServer server(static_cast<uint16_t>(port),
+                                        static_cast<unsigned int>(threads), bindAddress);
+        std::cout << "[Info] Shard worker listening on " << bindAddress << ":" << server.port()
+                  << std::endl;
+        server.serve(tasks);
+    } catch (const std::exception& e) {
+        std::cerr << "[Error] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
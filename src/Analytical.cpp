@@ -42,4 +42,74 @@ Greeks BlackScholesAnalytical::calculate(double S, double K, double T, double r,
     return g;
 }
 
+Greeks BlackScholesAnalytical::calculateIntegrated(double S, double K, double integratedRate,
+                                                   double integratedVariance, OptionType type) {
+    const double discK = K * std::exp(-integratedRate);
+    const double sign = (type == OptionType::Call) ? 1.0 : -1.0;
+    if (integratedVariance <= 0.0) {
+        // Нулевая дисперсия: дисконтированная внутренняя стоимость форварда
+        double val = std::max(sign * (S - discK), 0.0);
+        return {val, (val > 0.0) ? sign : 0.0, 0.0};
+    }
+
+    const double stdDev = std::sqrt(integratedVariance);
+    const double d1 = std::log(S / discK) / stdDev + 0.5 * stdDev;
+    const double d2 = d1 - stdDev;
+
+    Greeks g;
+    g.price = sign * (S * norm_cdf(sign * d1) - discK * norm_cdf(sign * d2));
+    g.delta = (type == OptionType::Call) ? norm_cdf(d1) : norm_cdf(d1) - 1.0;
+    g.gamma = norm_pdf(d1) / (S * stdDev);
+    return g;
+}
+
+Greeks BlackScholesAnalytical::calculateMerton(double S, double K, double T, double r,
+                                               double sigma, double jumpIntensity,
+                                               double jumpMean, double jumpVol,
+                                               OptionType type) {
+    const double kappa = std::exp(jumpMean + 0.5 * jumpVol * jumpVol) - 1.0;
+    const double intensity = jumpIntensity * (1.0 + kappa) * T;  // lambda' T
+    if (T <= 0.0 || intensity <= 0.0) {
+        return calculate(S, K, T, r - jumpIntensity * kappa, sigma, type);
+    }
+
+    Greeks g{0.0, 0.0, 0.0};
+    double weight = std::exp(-intensity);
+    for (int n = 0; n < 1000; ++n) {
+        const double jumps = static_cast<double>(n);
+        const double rate = r - jumpIntensity * kappa + jumps * std::log1p(kappa) / T;
+        const double vol = std::sqrt(sigma * sigma + jumps * jumpVol * jumpVol / T);
+        const Greeks term = calculate(S, K, T, rate, vol, type);
+        g.price += weight * term.price;
+        g.delta += weight * term.delta;
+        g.gamma += weight * term.gamma;
+        // Хвост пуассоновских весов за модой убывает быстрее геометрической прогрессии
+        if (jumps > intensity && weight < 1e-16) break;
+        weight *= intensity / (jumps + 1.0);
+    }
+    return g;
+}
+
+void BlackScholesAnalytical::priceBatch(std::size_t n, const double* S, const double* K,
+                                        const double* T, const double* r, const double* sigma,
+                                        const OptionType* type, double* price) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double t = std::max(T[i], 0.0);
+        double discK = K[i] * std::exp(-r[i] * t);
+        double sign = (type[i] == OptionType::Call) ? 1.0 : -1.0;
+        double volSqrtT = sigma[i] * std::sqrt(t);
+
+        if (volSqrtT <= 0.0) {
+            // Вырожденный случай: дисконтированная внутренняя стоимость форварда
+            price[i] = std::max(sign * (S[i] - discK), 0.0);
+            continue;
+        }
+
+        double d1 = std::log(S[i] / discK) / volSqrtT + 0.5 * volSqrtT;
+        double d2 = d1 - volSqrtT;
+        // Call: S N(d1) - K e^{-rT} N(d2);  Put: K e^{-rT} N(-d2) - S N(-d1)
+        price[i] = sign * (S[i] * norm_cdf(sign * d1) - discK * norm_cdf(sign * d2));
+    }
+}
+
 }  // namespace mcopt
\ No newline at end of file
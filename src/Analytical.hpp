@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 /**
  * @file Analytical.hpp
  * @brief Аналитические формулы оценки опционов.
@@ -50,6 +52,62 @@ class BlackScholesAnalytical {
      */
     [[nodiscard]] static Greeks calculate(double S, double K, double T, double r, double sigma,
                                           OptionType type);
+    /**
+     * @brief Black-Scholes price from integrated parameters (time-dependent rate and vol).
+     *
+     * With \f$ R = \int_0^T r(t)\,dt \f$ and \f$ V = \int_0^T \sigma(t)^2\,dt \f$ the
+     * terminal log-spot is normal with mean \f$ \log S + R - V/2 \f$ and variance \f$ V \f$.
+     * For discrete dividends pass the spot net of the present value of cash dividends and
+     * multiplied by \f$ \prod (1 - \delta_i) \f$ (escrowed-dividend model).
+     *
+     * @param S Spot price (dividend-adjusted, see above).
+     * @param K Strike price.
+     * @param integratedRate \f$ R \f$; the discount factor is \f$ e^{-R} \f$.
+     * @param integratedVariance \f$ V \f$ (total variance to maturity).
+     * @param type Option type (Call or Put).
+     * @return Greeks structure; delta and gamma are with respect to S.
+     */
+    [[nodiscard]] static Greeks calculateIntegrated(double S, double K, double integratedRate,
+                                                    double integratedVariance, OptionType type);
+    /**
+     * @brief Merton (1976) jump-diffusion price as a Poisson-weighted series of Black-Scholes
+     * prices.
+     *
+     * Log-jumps are \f$ N(\mu_J, \delta_J^2) \f$ with intensity \f$ \lambda \f$ and
+     * \f$ \kappa = e^{\mu_J + \delta_J^2 / 2} - 1 \f$. With
+     * \f$ \lambda' = \lambda (1 + \kappa) \f$:
+     * \f[
+     * V = \sum_{n \ge 0} e^{-\lambda' T} \frac{(\lambda' T)^n}{n!}
+     *     BS\left(S, K, T, r - \lambda\kappa + \frac{n \log(1 + \kappa)}{T},
+     *     \sqrt{\sigma^2 + n \delta_J^2 / T}\right).
+     * \f]
+     * Terms are summed past the mode of the Poisson weights until they drop below
+     * \f$ 10^{-16} \f$ (at most 1000 terms). Delta and gamma are the weighted sums of the
+     * term Greeks.
+     *
+     * @param jumpIntensity \f$ \lambda \f$ (jumps per year).
+     * @param jumpMean \f$ \mu_J \f$, mean of the log-jump.
+     * @param jumpVol \f$ \delta_J \f$, standard deviation of the log-jump.
+     */
+    [[nodiscard]] static Greeks calculateMerton(double S, double K, double T, double r,
+                                                double sigma, double jumpIntensity,
+                                                double jumpMean, double jumpVol,
+                                                OptionType type);
+    /**
+     * @brief Prices a batch of European options (structure-of-arrays layout).
+     *
+     * Branch-light loop over contiguous arrays, suitable for pricing many positions under many
+     * scenarios. Options with \f$ T \le 0 \f$ or \f$ \sigma \le 0 \f$ are priced at their
+     * discounted forward intrinsic value.
+     *
+     * @param n Number of options.
+     * @param S, K, T, r, sigma Arrays of length n with the inputs of calculate().
+     * @param type Array of length n with the option types.
+     * @param price Output array of length n.
+     */
+    static void priceBatch(std::size_t n, const double* S, const double* K, const double* T,
+                           const double* r, const double* sigma, const OptionType* type,
+                           double* price);
 };
 
 }  // namespace mcopt
\ No newline at end of file
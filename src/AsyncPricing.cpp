@@ -0,0 +1,60 @@
+#include "AsyncPricing.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace mcopt {
+
+namespace {
+
+// Атомарное сложение для double (fetch_add для плавающей точки появился только в C++20)
+void atomicAdd(std::atomic<double>& target, double value) noexcept {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+PricingState::PricingState(unsigned long long totalPaths, double discount) noexcept
+    : m_totalPaths(totalPaths), m_discount(discount) {}
+
+void PricingState::addBlock(const PathStatistics& block, unsigned long long paths) noexcept {
+    atomicAdd(m_sum, block.sum);
+    atomicAdd(m_sumSq, block.sumSq);
+    m_count.fetch_add(block.count, std::memory_order_release);
+    m_pathsDone.fetch_add(paths, std::memory_order_release);
+}
+
+PricingProgress PricingState::progress() const noexcept {
+    PathStatistics stats;
+    unsigned long long paths = m_pathsDone.load(std::memory_order_acquire);
+    stats.count = m_count.load(std::memory_order_acquire);
+    stats.sum = m_sum.load(std::memory_order_relaxed);
+    stats.sumSq = m_sumSq.load(std::memory_order_relaxed);
+    return {paths, m_totalPaths, m_discount * stats.mean(), m_discount * stats.standardError()};
+}
+
+PricingHandle::PricingHandle(std::shared_ptr<PricingState> state,
+                             std::future<PricingResult> result)
+    : m_state(std::move(state)), m_result(std::move(result)) {
+    if (!m_state || !m_result.valid()) {
+        throw std::invalid_argument("Pricing handle needs a state and a pending result.");
+    }
+}
+
+bool PricingHandle::ready() const { return waitFor(std::chrono::milliseconds(0)); }
+
+bool PricingHandle::waitFor(std::chrono::milliseconds timeout) const {
+    if (!m_result.valid()) return true;  // Результат уже забран
+    return m_result.wait_for(timeout) == std::future_status::ready;
+}
+
+PricingResult PricingHandle::get() {
+    if (!m_result.valid()) {
+        throw std::logic_error("Pricing result has already been retrieved.");
+    }
+    return m_result.get();
+}
+
+}  // namespace mcopt
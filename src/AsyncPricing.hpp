@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "Statistics.hpp"
+
+/**
+ * @file AsyncPricing.hpp
+ * @brief Асинхронный расчет: дескриптор с результатом, прогрессом и отменой.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct PricingProgress
+ * @brief Snapshot of a running calculation.
+ *
+ * The estimate and its standard error are discounted and cover the blocks finished so far.
+ */
+struct PricingProgress {
+    unsigned long long pathsDone;   ///< Paths in finished blocks.
+    unsigned long long totalPaths;  ///< Paths requested.
+    double estimate;                ///< Running price estimate (0 before the first block).
+    double standardError;           ///< Standard error of the running estimate.
+};
+
+/**
+ * @class PricingState
+ * @brief State shared between a PricingHandle and the workers of its calculation.
+ *
+ * Workers publish each finished block with addBlock(); readers take snapshots with progress().
+ * Both are lock-free (atomic compare-and-swap on the running sums). The three sums are updated
+ * one after another, so a snapshot taken while a block is being published may mix two
+ * consecutive states; the final result never does.
+ */
+class PricingState {
+   public:
+    /// @param totalPaths Paths requested. @param discount Discount factor of the estimate.
+    PricingState(unsigned long long totalPaths, double discount) noexcept;
+
+    /// @brief Publishes the statistics of a finished block of `paths` paths.
+    void addBlock(const PathStatistics& block, unsigned long long paths) noexcept;
+    /// @brief Lock-free snapshot of the progress.
+    [[nodiscard]] PricingProgress progress() const noexcept;
+
+    /// @brief Requests cancellation; workers stop before their next block.
+    void cancel() noexcept { m_cancelled.store(true, std::memory_order_relaxed); }
+    /// @brief True once cancel() has been called.
+    [[nodiscard]] bool cancelled() const noexcept {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+    /// @brief Discount factor applied to the estimate.
+    [[nodiscard]] double discount() const noexcept { return m_discount; }
+
+   private:
+    const unsigned long long m_totalPaths;
+    const double m_discount;
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<double> m_sum{0.0};
+    std::atomic<double> m_sumSq{0.0};
+    std::atomic<unsigned long long> m_count{0};
+    std::atomic<unsigned long long> m_pathsDone{0};
+};
+
+/**
+ * @class PricingHandle
+ * @brief Handle of a calculation started by MonteCarloEngine::calculatePriceAsync() or
+ * MonteCarloEngine::calculateAsianPriceAsync().
+ *
+ * The calculation runs on its own threads; the handle can be polled for progress from any
+ * thread and cancelled cooperatively: workers check the flag between RNG blocks, so a
+ * cancelled calculation finishes within one block per thread and still returns the estimate
+ * over all finished blocks. Destroying the handle waits for the calculation to finish.
+ */
+class PricingHandle {
+   public:
+    PricingHandle(std::shared_ptr<PricingState> state, std::future<PricingResult> result);
+
+    /// @brief Current progress (lock-free, may be called from any thread).
+    [[nodiscard]] PricingProgress progress() const noexcept { return m_state->progress(); }
+
+    /// @brief Requests cooperative cancellation.
+    void cancel() noexcept { m_state->cancel(); }
+    /// @brief True if cancellation was requested.
+    [[nodiscard]] bool cancelled() const noexcept { return m_state->cancelled(); }
+
+    /// @brief True once the result is available.
+    [[nodiscard]] bool ready() const;
+    /// @brief Waits up to `timeout` for the result; returns ready().
+    [[nodiscard]] bool waitFor(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief Waits for the calculation and returns its result (may be called once).
+     *
+     * For a completed run the result is identical to the blocking call. After cancellation
+     * `paths` is the number of paths actually simulated.
+     * @throws Any exception raised by the calculation.
+     */
+    [[nodiscard]] PricingResult get();
+
+   private:
+    std::shared_ptr<PricingState> m_state;
+    std::future<PricingResult> m_result;
+};
+
+}  // namespace mcopt
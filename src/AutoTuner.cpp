@@ -0,0 +1,308 @@
+#include "AutoTuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "RandomStream.hpp"
+#include "Serialization.hpp"
+
+namespace mcopt {
+
+namespace {
+
+unsigned int hardwareThreads() noexcept {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return (hw > 0) ? hw : 1;
+}
+
+// Потоки-кандидаты: 1, 2, 4, ... и максимум
+std::vector<unsigned int> threadCandidates() {
+    const unsigned int hw = hardwareThreads();
+    std::vector<unsigned int> threads;
+    for (unsigned int t = 1; t < hw; t *= 2) threads.push_back(t);
+    threads.push_back(hw);
+    return threads;
+}
+
+struct Candidate {
+    VarianceReduction method;
+    Precision precision;
+};
+
+struct Measurement {
+    PricingResult result;
+    double seconds;
+};
+
+Measurement timeRun(const MonteCarloEngine& engine, unsigned int numSteps,
+                    VarianceReduction method, unsigned long long paths) {
+    auto start = std::chrono::steady_clock::now();
+    PricingResult result = AutoTuner::run(engine, numSteps, method, paths);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return {result, elapsed.count()};
+}
+
+double variancePerPath(const PricingResult& r) {
+    return r.standardError * r.standardError * static_cast<double>(r.paths);
+}
+
+// Наименьшее число путей, допустимое для всех оценщиков (стратификация: 2 пары на страту)
+constexpr unsigned long long MIN_PATHS = 1024;
+
+// Настройки LHS, с которыми run() вызывает calculateLatinHypercubePrice()
+constexpr unsigned int LATIN_HYPERCUBE_DIMENSIONS = 4;
+constexpr unsigned int LATIN_HYPERCUBE_REPLICATES = 32;
+
+// Шаг числа путей, которое оценщик использует целиком: пары, у LHS — пары в каждой реплике
+unsigned long long pathGranularity(VarianceReduction method) noexcept {
+    return (method == VarianceReduction::LatinHypercube) ? 2ULL * LATIN_HYPERCUBE_REPLICATES : 2;
+}
+
+}  // namespace
+
+AutoTuner::AutoTuner(std::string profilePath, unsigned long long pilotPaths)
+    : m_profilePath(std::move(profilePath)), m_pilotPaths(pilotPaths) {
+    if (m_pilotPaths < 4 * MIN_PATHS) {
+        throw std::invalid_argument("Auto-tuner needs at least 4096 pilot paths.");
+    }
+    if (!m_profilePath.empty()) {
+        load(m_profilePath);
+    }
+}
+
+std::string AutoTuner::productClass(const MonteCarloEngine& engine, unsigned int numSteps) {
+    std::string key = engine.payoff().name() + ';' + std::to_string(numSteps);
+    if (engine.hasTermStructure()) key += ";ts";
+    return key;
+}
+
+PricingResult AutoTuner::run(const MonteCarloEngine& engine, unsigned int numSteps,
+                             VarianceReduction method, unsigned long long numSimulations) {
+    switch (method) {
+        case VarianceReduction::Stratified:
+            return engine.calculateStratifiedPrice(numSimulations, numSteps);
+        case VarianceReduction::LatinHypercube:
+            return engine.calculateLatinHypercubePrice(numSimulations, numSteps,
+                                                       LATIN_HYPERCUBE_DIMENSIONS,
+                                                       LATIN_HYPERCUBE_REPLICATES);
+        case VarianceReduction::ImportanceSampling: {
+            ImportanceSamplingResult is = (numSteps == 0)
+                                              ? engine.calculatePriceIS(numSimulations)
+                                              : engine.calculateAsianPriceIS(numSimulations,
+                                                                             numSteps);
+            return {is.price, is.standardError, is.paths};
+        }
+        case VarianceReduction::Antithetic:
+            break;
+    }
+    // Обычные ядра через simulateBlocks: тот же результат, что calculatePrice(), но без кэша
+    PathStatistics stats = reduceBlocks(
+        engine.simulateBlocks(0, blockCount(numSimulations), numSimulations, numSteps));
+    const double discount = engine.discountFactor();
+    return {discount * stats.mean(), discount * stats.standardError(), numSimulations};
+}
+
+const TuningEntry& AutoTuner::tune(const MonteCarloEngine& engine, unsigned int numSteps) {
+    MonteCarloEngine pilot = engine;
+    pilot.setResultCache(nullptr);
+    pilot.setNumThreads(hardwareThreads());
+
+    std::vector<Candidate> candidates = {{VarianceReduction::Antithetic, Precision::Double},
+                                         {VarianceReduction::Antithetic, Precision::Single}};
+    if (!engine.hasTermStructure()) {
+        candidates.push_back({VarianceReduction::Stratified, Precision::Double});
+        candidates.push_back({VarianceReduction::LatinHypercube, Precision::Double});
+        candidates.push_back({VarianceReduction::ImportanceSampling, Precision::Double});
+    }
+
+    // Прогрев: первые вызовы платят за аллокации и холодные кэши
+    static_cast<void>(run(pilot, numSteps, VarianceReduction::Antithetic, MIN_PATHS));
+
+    // Этап 1: метод с наименьшей работой на единицу точности (дисперсия x время на путь)
+    TuningEntry best{};
+    double bestScore = 0.0;
+    bool found = false;
+    for (const Candidate& c : candidates) {
+        pilot.setPrecision(c.precision);
+        Measurement m = timeRun(pilot, numSteps, c.method, m_pilotPaths);
+        double variance = variancePerPath(m.result);
+        double score = variance * m.seconds / static_cast<double>(m.result.paths);
+        if (!found || score < bestScore) {
+            best.method = c.method;
+            best.precision = c.precision;
+            best.variancePerPath = variance;
+            bestScore = score;
+            found = true;
+        }
+    }
+
+    // Этап 2: модель t(N) = a + bN для каждого числа потоков по двум размерам пилота
+    pilot.setPrecision(best.precision);
+    const unsigned long long small = m_pilotPaths / 4;
+    const unsigned long long large = m_pilotPaths;
+    for (unsigned int threads : threadCandidates()) {
+        pilot.setNumThreads(threads);
+        double t1 = timeRun(pilot, numSteps, best.method, small).seconds;
+        double t2 = timeRun(pilot, numSteps, best.method, large).seconds;
+        double perPath = (t2 - t1) / static_cast<double>(large - small);
+        double overhead = t1 - perPath * static_cast<double>(small);
+        if (!(perPath > 0.0) || overhead < 0.0) {
+            // Шум замеров: считаем стоимость пропорциональной числу путей
+            perPath = t2 / static_cast<double>(large);
+            overhead = 0.0;
+        }
+        best.timings.push_back({threads, overhead, perPath});
+    }
+
+    TuningEntry& entry = m_entries[productClass(engine, numSteps)];
+    entry = std::move(best);
+    if (!m_profilePath.empty()) {
+        save(m_profilePath);
+    }
+    return entry;
+}
+
+PricingPlan AutoTuner::plan(const MonteCarloEngine& engine, unsigned int numSteps,
+                            double targetStandardError, bool reuseTunedVariance) {
+    if (!(targetStandardError > 0.0)) {
+        throw std::invalid_argument("Target standard error must be positive.");
+    }
+    const std::string key = productClass(engine, numSteps);
+    auto it = m_entries.find(key);
+    const TuningEntry& entry = (it != m_entries.end()) ? it->second : tune(engine, numSteps);
+
+    auto predicted = [](const ThreadTiming& t, unsigned long long paths) {
+        return t.overheadSeconds + t.secondsPerPath * static_cast<double>(paths);
+    };
+    auto fastest = [&](unsigned long long paths) -> const ThreadTiming& {
+        return *std::min_element(entry.timings.begin(), entry.timings.end(),
+                                 [&](const ThreadTiming& a, const ThreadTiming& b) {
+                                     return predicted(a, paths) < predicted(b, paths);
+                                 });
+    };
+
+    // Дисперсия зависит от страйка и рынка, поэтому оцениваем ее на этом движке; пилот
+    // запускается на самом быстром для его размера числе потоков и входит в прогноз времени
+    double variance = entry.variancePerPath;
+    double pilotSeconds = 0.0;
+    if (!reuseTunedVariance) {
+        const unsigned long long pilotPaths = m_pilotPaths / 4;
+        const ThreadTiming& t = fastest(pilotPaths);
+        MonteCarloEngine pilot = engine;
+        pilot.setResultCache(nullptr);
+        pilot.setPrecision(entry.precision);
+        pilot.setNumThreads(t.threads);
+        variance = variancePerPath(run(pilot, numSteps, entry.method, pilotPaths));
+        pilotSeconds = predicted(t, pilotPaths);
+    }
+
+    // Вверх до шага оценщика: LHS отбрасывает неполные реплики, и ошибка была бы выше прогноза
+    double required = std::ceil(variance / (targetStandardError * targetStandardError));
+    const unsigned long long step = pathGranularity(entry.method);
+    auto paths = std::max(MIN_PATHS, static_cast<unsigned long long>(required));
+    paths = (paths + step - 1) / step * step;
+
+    const ThreadTiming& best = fastest(paths);
+    PricingPlan result{};
+    result.method = entry.method;
+    result.precision = entry.precision;
+    result.threads = best.threads;
+    result.paths = paths;
+    result.pilotSeconds = pilotSeconds;
+    result.predictedSeconds = pilotSeconds + predicted(best, paths);
+    result.predictedStandardError = std::sqrt(variance / static_cast<double>(paths));
+    return result;
+}
+
+TunedResult AutoTuner::price(const MonteCarloEngine& engine, unsigned int numSteps,
+                             double targetStandardError, bool reuseTunedVariance) {
+    PricingPlan p = plan(engine, numSteps, targetStandardError, reuseTunedVariance);
+    MonteCarloEngine worker = engine;
+    worker.setResultCache(nullptr);
+    worker.setPrecision(p.precision);
+    worker.setNumThreads(p.threads);
+    Measurement m = timeRun(worker, numSteps, p.method, p.paths);
+    return {p, m.result, m.seconds};
+}
+
+std::optional<TuningEntry> AutoTuner::find(const std::string& productClass) const {
+    auto it = m_entries.find(productClass);
+    if (it == m_entries.end()) return std::nullopt;
+    return it->second;
+}
+
+// Формат: заголовок с числом потоков машины, затем на запись две строки — класс продукта
+// и параметры (метод, точность, дисперсия, модели времени по потокам)
+void AutoTuner::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open tuning profile " + path + " for writing.");
+    }
+    file << "MCTUNE 1 " << hardwareThreads() << ' ' << m_entries.size() << '\n';
+    for (const auto& [key, e] : m_entries) {
+        file << key << '\n'
+             << static_cast<int>(e.method) << ' ' << static_cast<int>(e.precision) << ' '
+             << doubleToBits(e.variancePerPath) << ' ' << e.timings.size();
+        for (const ThreadTiming& t : e.timings) {
+            file << ' ' << t.threads << ' ' << doubleToBits(t.overheadSeconds) << ' '
+                 << doubleToBits(t.secondsPerPath);
+        }
+        file << '\n';
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write tuning profile " + path);
+    }
+}
+
+void AutoTuner::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+
+    std::string tag;
+    int version = 0;
+    unsigned int machineThreads = 0;
+    std::size_t count = 0;
+    file >> tag >> version >> machineThreads >> count >> std::ws;
+    if (tag != "MCTUNE" || version != 1) {
+        throw std::runtime_error("Unrecognised tuning profile " + path);
+    }
+    if (machineThreads != hardwareThreads()) return;  // Профиль другой машины
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string key;
+        std::getline(file, key);
+        int method = 0;
+        int precision = 0;
+        std::size_t timings = 0;
+        TuningEntry e{};
+        file >> method >> precision;
+        // Значения вне перечислений — поврежденный профиль, а не неизвестная настройка
+        if (method < 0 || method > static_cast<int>(VarianceReduction::ImportanceSampling) ||
+            precision < 0 || precision > static_cast<int>(Precision::Single)) {
+            throw std::runtime_error("Malformed tuning profile " + path);
+        }
+        e.method = static_cast<VarianceReduction>(method);
+        e.precision = static_cast<Precision>(precision);
+        e.variancePerPath = readDoubleBits(file);
+        file >> timings;
+        for (std::size_t k = 0; k < timings && file; ++k) {
+            ThreadTiming t{};
+            file >> t.threads;
+            t.overheadSeconds = readDoubleBits(file);
+            t.secondsPerPath = readDoubleBits(file);
+            e.timings.push_back(t);
+        }
+        file >> std::ws;
+        if (file.fail() || e.timings.empty()) {
+            throw std::runtime_error("Malformed tuning profile " + path);
+        }
+        m_entries[key] = std::move(e);
+    }
+}
+
+}  // namespace mcopt
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "MCEngine.hpp"
+#include "Statistics.hpp"
+
+/**
+ * @file AutoTuner.hpp
+ * @brief Автоматический выбор потоков, точности и метода снижения дисперсии по пилотным прогонам.
+ */
+
+namespace mcopt {
+
+/**
+ * @enum VarianceReduction
+ * @brief Estimator used to price a request.
+ */
+enum class VarianceReduction {
+    Antithetic,          ///< calculatePrice() / calculateAsianPrice() kernels.
+    Stratified,          ///< calculateStratifiedPrice() with proportional allocation.
+    LatinHypercube,      ///< calculateLatinHypercubePrice().
+    ImportanceSampling   ///< calculatePriceIS() / calculateAsianPriceIS().
+};
+
+/**
+ * @struct ThreadTiming
+ * @brief Fitted wall-clock model \f$ t(N) = a + b N \f$ of one thread count.
+ *
+ * The fixed part \f$ a \f$ (thread start-up, per-call set-up) is what makes small jobs scale
+ * poorly, so it decides the thread count for short requests.
+ */
+struct ThreadTiming {
+    unsigned int threads;    ///< Number of threads.
+    double overheadSeconds;  ///< \f$ a \f$.
+    double secondsPerPath;   ///< \f$ b \f$.
+};
+
+/**
+ * @struct TuningEntry
+ * @brief Best configuration of one product class on this machine.
+ */
+struct TuningEntry {
+    VarianceReduction method;           ///< Estimator with the lowest variance x time.
+    Precision precision;                ///< Kernel precision (Single only for Antithetic).
+    double variancePerPath;             ///< Pilot \f$ SE^2 N \f$ of the chosen estimator.
+    std::vector<ThreadTiming> timings;  ///< Cost model per candidate thread count.
+};
+
+/**
+ * @struct PricingPlan
+ * @brief Settings chosen for one request and the predicted cost.
+ */
+struct PricingPlan {
+    VarianceReduction method;       ///< Estimator.
+    Precision precision;            ///< Kernel precision.
+    unsigned int threads;           ///< Thread count minimising the predicted time.
+    unsigned long long paths;       ///< Paths for the target error, a multiple the method uses.
+    double pilotSeconds;            ///< Predicted time of the variance pilot (0 if skipped).
+    double predictedSeconds;        ///< \f$ a + b N \f$ of the chosen thread count plus the pilot.
+    double predictedStandardError;  ///< \f$ \sqrt{V / N} \f$.
+};
+
+/**
+ * @struct TunedResult
+ * @brief Result of an auto-tuned pricing call.
+ */
+struct TunedResult {
+    PricingPlan plan;      ///< Plan that was executed.
+    PricingResult result;  ///< Price, standard error and paths.
+    double seconds;        ///< Measured wall-clock time of the pricing run.
+};
+
+/**
+ * @class AutoTuner
+ * @brief Picks threads, precision and variance reduction to reach a target standard error
+ * in the least time.
+ *
+ * A product class is the payoff type and the number of time steps (0 for European). Tuning
+ * a class runs short pilots of every applicable estimator on all threads and keeps the one
+ * with the lowest variance x time per path; it then fits \f$ t(N) = a + b N \f$ for thread
+ * counts 1, 2, 4, ... up to the hardware concurrency. The RNG block size is not a tuning knob:
+ * it is fixed by the reproducible block layout (PATHS_PER_BLOCK), and the thread count
+ * determines how many blocks each thread takes.
+ *
+ * Entries are kept in a profile file tagged with the hardware concurrency; a profile written
+ * on a machine with a different thread count is ignored and classes are tuned again.
+ * The tuner is not thread-safe.
+ */
+class AutoTuner {
+   public:
+    /**
+     * @param profilePath Profile file ("" = memory only); loaded if it exists, rewritten after
+     * each tuning run.
+     * @param pilotPaths Paths of the largest pilot run.
+     * @throws std::invalid_argument If pilotPaths < 4096.
+     * @throws std::runtime_error If the profile file is malformed.
+     */
+    explicit AutoTuner(std::string profilePath = "", unsigned long long pilotPaths = 1ULL << 16);
+
+    /// @brief Product class key of an engine and step count.
+    [[nodiscard]] static std::string productClass(const MonteCarloEngine& engine,
+                                                  unsigned int numSteps);
+
+    /**
+     * @brief Runs the calibration pilots for the engine's product class and stores the result.
+     *
+     * Importance sampling, stratified and Latin hypercube sampling are skipped when the engine
+     * has a term structure (they assume constant parameters).
+     */
+    const TuningEntry& tune(const MonteCarloEngine& engine, unsigned int numSteps);
+
+    /**
+     * @brief Settings and predicted runtime for pricing to a target standard error.
+     *
+     * Tunes the product class first if the profile has no entry for it. The variance per path
+     * is re-estimated with a quarter-size pilot on this engine, since it depends on the strike
+     * and market data and not only on the product class; the pilot runs on the thread count
+     * that is fastest for its size and its predicted cost is part of predictedSeconds.
+     * @param reuseTunedVariance Skip the pilot and use the entry's variancePerPath (cheaper for
+     * small requests, but exact only for the engine the class was tuned on).
+     * @throws std::invalid_argument If targetStandardError <= 0.
+     */
+    [[nodiscard]] PricingPlan plan(const MonteCarloEngine& engine, unsigned int numSteps,
+                                   double targetStandardError, bool reuseTunedVariance = false);
+
+    /// @brief Plans and executes the request on a copy of the engine.
+    [[nodiscard]] TunedResult price(const MonteCarloEngine& engine, unsigned int numSteps,
+                                    double targetStandardError, bool reuseTunedVariance = false);
+
+    /// @brief Stored entry of a product class, if tuned.
+    [[nodiscard]] std::optional<TuningEntry> find(const std::string& productClass) const;
+
+    /**
+     * @brief Writes the profile to a text file.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Loads a profile written by save(); a missing file or another machine's profile
+     * is ignored.
+     * @throws std::runtime_error If the file is malformed or names an unknown method or
+     * precision.
+     */
+    void load(const std::string& path);
+
+    /// @brief Runs one estimator with the engine's current threads and precision.
+    [[nodiscard]] static PricingResult run(const MonteCarloEngine& engine, unsigned int numSteps,
+                                           VarianceReduction method,
+                                           unsigned long long numSimulations);
+
+   private:
+    std::string m_profilePath;
+    unsigned long long m_pilotPaths;
+    std::map<std::string, TuningEntry> m_entries;
+};
+
+}  // namespace mcopt
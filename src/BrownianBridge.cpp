@@ -0,0 +1,68 @@
+#include "BrownianBridge.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace mcopt {
+
+BrownianBridge::BrownianBridge(std::size_t numSteps)
+    : m_bridgeIndex(numSteps),
+      m_leftIndex(numSteps),
+      m_rightIndex(numSteps),
+      m_leftWeight(numSteps),
+      m_rightWeight(numSteps),
+      m_stdDev(numSteps) {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Brownian bridge needs at least one time step.");
+    }
+    const std::size_t n = numSteps;
+    auto time = [](std::size_t i) { return static_cast<double>(i + 1); };  // t_i = i + 1
+
+    // map[i] != 0: точка i уже построена (хранит номер переменной + 1)
+    std::vector<std::size_t> map(n, 0);
+    map[n - 1] = 1;
+    m_bridgeIndex[0] = n - 1;
+    m_stdDev[0] = std::sqrt(time(n - 1));
+
+    std::size_t j = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+        while (map[j] != 0) ++j;  // Первая непостроенная точка
+        std::size_t k = j;
+        while (map[k] == 0) ++k;  // Следующая построенная справа
+        std::size_t l = j + ((k - 1 - j) >> 1);  // Середина промежутка
+        map[l] = i + 1;
+        m_bridgeIndex[i] = l;
+        m_leftIndex[i] = j;
+        m_rightIndex[i] = k;
+        if (j != 0) {
+            double span = time(k) - time(j - 1);
+            m_leftWeight[i] = (time(k) - time(l)) / span;
+            m_rightWeight[i] = (time(l) - time(j - 1)) / span;
+            m_stdDev[i] = std::sqrt((time(l) - time(j - 1)) * (time(k) - time(l)) / span);
+        } else {
+            m_leftWeight[i] = (time(k) - time(l)) / time(k);
+            m_rightWeight[i] = time(l) / time(k);
+            m_stdDev[i] = std::sqrt(time(l) * (time(k) - time(l)) / time(k));
+        }
+        j = k + 1;
+        if (j >= n) j = 0;
+    }
+}
+
+void BrownianBridge::buildPath(const double* z, double* path) const noexcept {
+    const std::size_t n = size();
+    path[n - 1] = m_stdDev[0] * z[0];
+    for (std::size_t i = 1; i < n; ++i) {
+        std::size_t j = m_leftIndex[i];
+        std::size_t k = m_rightIndex[i];
+        std::size_t l = m_bridgeIndex[i];
+        if (j != 0) {
+            path[l] = m_leftWeight[i] * path[j - 1] + m_rightWeight[i] * path[k] +
+                      m_stdDev[i] * z[i];
+        } else {
+            path[l] = m_rightWeight[i] * path[k] + m_stdDev[i] * z[i];
+        }
+    }
+}
+
+}  // namespace mcopt
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file BrownianBridge.hpp
+ * @brief Построение броуновской траектории мостом: сначала конец, затем середины.
+ */
+
+namespace mcopt {
+
+/**
+ * @class BrownianBridge
+ * @brief Brownian bridge construction on an equally spaced grid (Jäckel's ordering).
+ *
+ * Normal variate 0 fixes the terminal value \f$ W(t_N) \f$, variate 1 the midpoint, and so on
+ * by recursive bisection. The first few variates therefore carry most of the variance of
+ * path functionals such as the average, which makes them the right dimensions to stratify.
+ */
+class BrownianBridge {
+   public:
+    /**
+     * @param numSteps Number of grid points \f$ t_1 < \dots < t_N \f$ (unit spacing).
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    explicit BrownianBridge(std::size_t numSteps);
+
+    /// @brief Number of grid points.
+    [[nodiscard]] std::size_t size() const noexcept { return m_bridgeIndex.size(); }
+
+    /**
+     * @brief Builds \f$ W(t_1), \dots, W(t_N) \f$ with unit time step from N standard normals.
+     *
+     * Multiply by \f$ \sqrt{dt} \f$ for a grid with step dt.
+     * @param z Standard normals in bridge order (size N).
+     * @param path Output Brownian path (size N).
+     */
+    void buildPath(const double* z, double* path) const noexcept;
+
+   private:
+    std::vector<std::size_t> m_bridgeIndex;
+    std::vector<std::size_t> m_leftIndex;
+    std::vector<std::size_t> m_rightIndex;
+    std::vector<double> m_leftWeight;
+    std::vector<double> m_rightWeight;
+    std::vector<double> m_stdDev;
+};
+
+}  // namespace mcopt
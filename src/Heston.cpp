@@ -0,0 +1,443 @@
+#include "Heston.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "Constants.hpp"
+
+namespace mcopt {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+constexpr std::size_t NUM_PARAMETERS = 5;
+
+// Допустимая область калибровки: (v0, kappa, theta, sigma, rho)
+constexpr std::array<double, NUM_PARAMETERS> LOWER_BOUNDS = {1e-6, 1e-3, 1e-6, 1e-3, -0.999};
+constexpr std::array<double, NUM_PARAMETERS> UPPER_BOUNDS = {4.0, 50.0, 4.0, 5.0, 0.999};
+
+// Критерии остановки Левенберга-Марквардта и число перестроений диапазонов срезов
+constexpr double GRADIENT_TOLERANCE = 1e-12;
+constexpr double STEP_TOLERANCE = 1e-10;
+constexpr unsigned int MAX_RANGE_REBUILDS = 3;
+
+std::array<double, NUM_PARAMETERS> toArray(const HestonParameters& p) {
+    return {p.v0, p.kappa, p.theta, p.sigma, p.rho};
+}
+
+HestonParameters fromArray(const std::array<double, NUM_PARAMETERS>& x) {
+    return {x[0], x[1], x[2], x[3], x[4]};
+}
+
+// Решение симметричной положительно определенной системы 5x5 разложением Холецкого
+bool solveCholesky(std::array<std::array<double, NUM_PARAMETERS>, NUM_PARAMETERS> a,
+                   std::array<double, NUM_PARAMETERS>& x) {
+    for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) {
+        double diag = a[j][j];
+        for (std::size_t k = 0; k < j; ++k) diag -= a[j][k] * a[j][k];
+        if (!(diag > 0.0)) return false;
+        a[j][j] = std::sqrt(diag);
+        for (std::size_t i = j + 1; i < NUM_PARAMETERS; ++i) {
+            double s = a[i][j];
+            for (std::size_t k = 0; k < j; ++k) s -= a[i][k] * a[j][k];
+            a[i][j] = s / a[j][j];
+        }
+    }
+    for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+        for (std::size_t k = 0; k < i; ++k) x[i] -= a[i][k] * x[k];
+        x[i] /= a[i][i];
+    }
+    for (std::size_t i = NUM_PARAMETERS; i-- > 0;) {
+        for (std::size_t k = i + 1; k < NUM_PARAMETERS; ++k) x[i] -= a[k][i] * x[k];
+        x[i] /= a[i][i];
+    }
+    return true;
+}
+
+}  // namespace
+
+void validateHeston(const HestonParameters& p) {
+    if (!(p.v0 >= 0.0) || !(p.kappa > 0.0) || !(p.theta >= 0.0) || !(p.sigma > 0.0) ||
+        !(std::abs(p.rho) <= 1.0)) {
+        throw std::invalid_argument(
+            "Invalid Heston parameters (need v0, theta >= 0, kappa, sigma > 0, |rho| <= 1).");
+    }
+}
+
+HestonCOSPricer::HestonCOSPricer(double spot, double rate, std::size_t terms, double truncation)
+    : m_spot(spot), m_rate(rate), m_terms(terms), m_truncation(truncation) {
+    if (!(spot > 0.0) || terms < 2 || !(truncation > 0.0)) {
+        throw std::invalid_argument("COS pricer needs spot > 0, terms >= 2 and truncation > 0.");
+    }
+}
+
+void HestonCOSPricer::range(const HestonParameters& p, double T, double& a, double& b) const {
+    // Кумулянты log(S_T / S_0) (Fang, Oosterlee 2008)
+    const double k = p.kappa;
+    const double e = std::exp(-k * T);
+    const double c1 = m_rate * T + (1.0 - e) * (p.theta - p.v0) / (2.0 * k) - 0.5 * p.theta * T;
+    const double c2 =
+        (p.sigma * T * k * e * (p.v0 - p.theta) * (8.0 * k * p.rho - 4.0 * p.sigma) +
+         k * p.rho * p.sigma * (1.0 - e) * (16.0 * p.theta - 8.0 * p.v0) +
+         2.0 * p.theta * k * T * (-4.0 * k * p.rho * p.sigma + p.sigma * p.sigma + 4.0 * k * k) +
+         p.sigma * p.sigma *
+             ((p.theta - 2.0 * p.v0) * e * e + p.theta * (6.0 * e - 7.0) + 2.0 * p.v0) +
+         8.0 * k * k * (p.v0 - p.theta) * (1.0 - e)) /
+        (8.0 * k * k * k);
+    // При почти нулевой дисперсии диапазон не должен схлопнуться
+    const double width = m_truncation * std::sqrt(std::max(std::abs(c2), 1e-8));
+    a = c1 - width;
+    b = c1 + width;
+}
+
+HestonCOSPricer::Slice HestonCOSPricer::makeSlice(double maturity, std::vector<double> strikes,
+                                                  std::vector<OptionType> types,
+                                                  const HestonParameters& rangeParameters) const {
+    validateHeston(rangeParameters);
+    if (!(maturity > 0.0) || strikes.size() != types.size()) {
+        throw std::invalid_argument("Slice needs a positive maturity and one type per strike.");
+    }
+    Slice slice;
+    slice.maturity = maturity;
+    range(rangeParameters, maturity, slice.a, slice.b);
+    const double a = slice.a;
+    const double b = slice.b;
+    const double scale = 2.0 / (b - a);
+
+    // Коэффициенты пута V_k(K) = 2 / (b - a) * (K psi_k - S_0 chi_k) на [a, log(K / S_0)]
+    slice.coefficients.resize(strikes.size() * m_terms);
+    for (std::size_t i = 0; i < strikes.size(); ++i) {
+        if (!(strikes[i] > 0.0)) {
+            throw std::invalid_argument("Strikes must be positive.");
+        }
+        const double c = std::min(std::max(std::log(strikes[i] / m_spot), a), b);
+        double* row = slice.coefficients.data() + i * m_terms;
+        for (std::size_t k = 0; k < m_terms; ++k) {
+            const double u = static_cast<double>(k) * math::PI / (b - a);
+            const double cosine = std::cos(u * (c - a));
+            const double sine = std::sin(u * (c - a));
+            const double chi = (std::exp(c) * (cosine + u * sine) - std::exp(a)) / (1.0 + u * u);
+            const double psi = (k == 0) ? (c - a) : sine / u;
+            row[k] = scale * (strikes[i] * psi - m_spot * chi);
+        }
+        row[0] *= 0.5;
+    }
+    slice.strikes = std::move(strikes);
+    slice.types = std::move(types);
+    return slice;
+}
+
+bool HestonCOSPricer::covers(const Slice& slice, const HestonParameters& p) const {
+    double a = 0.0;
+    double b = 0.0;
+    range(p, slice.maturity, a, b);
+    return a >= slice.a && b <= slice.b;
+}
+
+void HestonCOSPricer::evaluate(const HestonParameters& p, const Slice& slice, double* prices,
+                               HestonGradient* gradients) const {
+    validateHeston(p);
+    const double T = slice.maturity;
+    const double s2 = p.sigma * p.sigma;
+    const double kt = p.kappa * p.theta / s2;
+    const double vs = p.v0 / s2;
+
+    // Re[phi(u_k) e^{-i u_k a}] и ее производные — один раз на срез
+    const std::size_t n = m_terms;
+    std::vector<double> weights(n);
+    std::vector<double> derivatives(gradients ? NUM_PARAMETERS * n : 0);
+    for (std::size_t k = 0; k < n; ++k) {
+        const double u = static_cast<double>(k) * math::PI / (slice.b - slice.a);
+        const Complex iu(0.0, u);
+        const Complex xi = p.kappa - p.sigma * p.rho * iu;
+        const Complex quad = u * u + iu;
+        const Complex d = std::sqrt(xi * xi + s2 * quad);
+        const Complex g = (xi - d) / (xi + d);
+        const Complex E = std::exp(-d * T);
+        const Complex denom = 1.0 - g * E;
+        const Complex A = (xi - d) * T - 2.0 * std::log(denom / (1.0 - g));
+        const Complex B = (xi - d) * (1.0 - E) / denom;
+        const Complex phase = std::exp(iu * (m_rate * T - slice.a) + kt * A + vs * B);
+        weights[k] = phase.real();
+        if (!gradients) continue;
+
+        // Производные A и B по kappa, sigma, rho через xi и d
+        auto partial = [&](Complex dxi, double dsigma, Complex& dA, Complex& dB) {
+            const Complex dd = (xi * dxi + p.sigma * dsigma * quad) / d;
+            const Complex dg = 2.0 * (d * dxi - xi * dd) / ((xi + d) * (xi + d));
+            const Complex dE = -T * E * dd;
+            const Complex dDenom = -(dg * E + g * dE);
+            dA = (dxi - dd) * T - 2.0 * dDenom / denom - 2.0 * dg / (1.0 - g);
+            dB = ((dxi - dd) * (1.0 - E) - (xi - d) * dE) / denom -
+                 (xi - d) * (1.0 - E) * dDenom / (denom * denom);
+        };
+        Complex dAk;
+        Complex dBk;
+        Complex dAs;
+        Complex dBs;
+        Complex dAr;
+        Complex dBr;
+        partial(1.0, 0.0, dAk, dBk);
+        partial(-p.rho * iu, 1.0, dAs, dBs);
+        partial(-p.sigma * iu, 0.0, dAr, dBr);
+
+        const Complex dLog[NUM_PARAMETERS] = {
+            B / s2,
+            p.theta / s2 * A + kt * dAk + vs * dBk,
+            p.kappa / s2 * A,
+            -2.0 / p.sigma * (kt * A + vs * B) + kt * dAs + vs * dBs,
+            kt * dAr + vs * dBr,
+        };
+        for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) {
+            derivatives[j * n + k] = (phase * dLog[j]).real();
+        }
+    }
+
+    // Все страйки среза: скалярные произведения с общими весами
+    const double discount = std::exp(-m_rate * T);
+    for (std::size_t i = 0; i < slice.strikes.size(); ++i) {
+        const double* row = slice.coefficients.data() + i * n;
+        double put = 0.0;
+        for (std::size_t k = 0; k < n; ++k) put += row[k] * weights[k];
+        put *= discount;
+        // Паритет колл-пут: производные пута и колла совпадают
+        prices[i] = (slice.types[i] == OptionType::Put)
+                        ? put
+                        : put + m_spot - slice.strikes[i] * discount;
+        if (!gradients) continue;
+        for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) {
+            const double* dw = derivatives.data() + j * n;
+            double sum = 0.0;
+            for (std::size_t k = 0; k < n; ++k) sum += row[k] * dw[k];
+            gradients[i][j] = discount * sum;
+        }
+    }
+}
+
+double HestonCOSPricer::price(const HestonParameters& p, double T, double K,
+                              OptionType type) const {
+    const Slice slice = makeSlice(T, {K}, {type}, p);
+    double result = 0.0;
+    evaluate(p, slice, &result);
+    return result;
+}
+
+HestonCalibrator::HestonCalibrator(double spot, double rate, std::vector<HestonQuote> quotes,
+                                   std::size_t terms)
+    : m_pricer(spot, rate, terms), m_quotes(std::move(quotes)) {
+    if (m_quotes.size() < NUM_PARAMETERS) {
+        throw std::invalid_argument("Heston calibration needs at least 5 quotes.");
+    }
+    for (const HestonQuote& q : m_quotes) {
+        if (!(q.maturity > 0.0) || !(q.strike > 0.0)) {
+            throw std::invalid_argument("Quotes need positive maturities and strikes.");
+        }
+    }
+    // Котировки упорядочены по сроку: срез занимает непрерывный отрезок
+    m_order.resize(m_quotes.size());
+    std::iota(m_order.begin(), m_order.end(), std::size_t{0});
+    std::stable_sort(m_order.begin(), m_order.end(), [&](std::size_t x, std::size_t y) {
+        return m_quotes[x].maturity < m_quotes[y].maturity;
+    });
+    for (std::size_t pos = 0; pos < m_order.size(); ++pos) {
+        const double T = m_quotes[m_order[pos]].maturity;
+        if (m_groups.empty() || m_groups.back().maturity != T) {
+            m_groups.push_back({T, pos, 0});
+        }
+        ++m_groups.back().count;
+    }
+    setNumThreads(0);
+}
+
+void HestonCalibrator::setNumThreads(unsigned int threads) {
+    unsigned int hw = std::thread::hardware_concurrency();
+    m_numThreads = (threads > 0) ? threads : ((hw > 0) ? hw : 1);
+}
+
+std::vector<HestonCOSPricer::Slice> HestonCalibrator::makeSlices(
+    const HestonParameters& rangeParameters) const {
+    std::vector<HestonCOSPricer::Slice> slices;
+    for (const Group& group : m_groups) {
+        std::vector<double> strikes;
+        std::vector<OptionType> types;
+        for (std::size_t pos = group.offset; pos < group.offset + group.count; ++pos) {
+            strikes.push_back(m_quotes[m_order[pos]].strike);
+            types.push_back(m_quotes[m_order[pos]].type);
+        }
+        slices.push_back(m_pricer.makeSlice(group.maturity, std::move(strikes),
+                                            std::move(types), rangeParameters));
+    }
+    return slices;
+}
+
+void HestonCalibrator::evaluate(const HestonParameters& p,
+                                const std::vector<HestonCOSPricer::Slice>& slices,
+                                std::vector<double>& prices,
+                                std::vector<HestonGradient>* gradients) const {
+    prices.resize(m_quotes.size());
+    if (gradients) gradients->resize(m_quotes.size());
+
+    // Срезы делятся между потоками непрерывными отрезками; каждый пишет в свой диапазон
+    const std::size_t numSlices = slices.size();
+    const std::size_t numThreads = std::min<std::size_t>(m_numThreads, numSlices);
+    auto priceRange = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t s = begin; s < end; ++s) {
+            const std::size_t offset = m_groups[s].offset;
+            m_pricer.evaluate(p, slices[s], prices.data() + offset,
+                              gradients ? gradients->data() + offset : nullptr);
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (std::size_t t = 1; t < numThreads; ++t) {
+        futures.push_back(std::async(std::launch::async, priceRange, numSlices * t / numThreads,
+                                     numSlices * (t + 1) / numThreads));
+    }
+    priceRange(0, numSlices / numThreads);
+    for (auto& f : futures) f.get();
+}
+
+std::vector<double> HestonCalibrator::modelPrices(const HestonParameters& p) const {
+    std::vector<double> sorted;
+    evaluate(p, makeSlices(p), sorted, nullptr);
+    std::vector<double> result(m_quotes.size());
+    for (std::size_t pos = 0; pos < m_order.size(); ++pos) result[m_order[pos]] = sorted[pos];
+    return result;
+}
+
+HestonCalibration HestonCalibrator::calibrate(const HestonParameters& initial,
+                                              unsigned int maxIterations) const {
+    validateHeston(initial);
+    std::array<double, NUM_PARAMETERS> x = toArray(initial);
+    for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) {
+        x[j] = std::min(std::max(x[j], LOWER_BOUNDS[j]), UPPER_BOUNDS[j]);
+    }
+
+    const std::size_t m = m_quotes.size();
+    std::vector<HestonCOSPricer::Slice> slices = makeSlices(fromArray(x));
+    std::vector<double> prices;
+    std::vector<HestonGradient> jacobian;
+    std::vector<double> trialPrices;
+    std::vector<HestonGradient> trialJacobian;
+    auto cost = [&](const std::vector<double>& model) {
+        double sum = 0.0;
+        for (std::size_t pos = 0; pos < m; ++pos) {
+            double residual = model[pos] - m_quotes[m_order[pos]].price;
+            sum += residual * residual;
+        }
+        return 0.5 * sum;
+    };
+
+    evaluate(fromArray(x), slices, prices, &jacobian);
+    double currentCost = cost(prices);
+    double mu = -1.0;
+    double nu = 2.0;
+    unsigned int rebuilds = 0;
+    bool converged = false;
+    unsigned int iteration = 0;
+    while (iteration < maxIterations) {
+        // Нормальные уравнения: J^T J и градиент J^T r
+        std::array<std::array<double, NUM_PARAMETERS>, NUM_PARAMETERS> normal{};
+        std::array<double, NUM_PARAMETERS> gradient{};
+        for (std::size_t pos = 0; pos < m; ++pos) {
+            const double residual = prices[pos] - m_quotes[m_order[pos]].price;
+            for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+                gradient[i] += jacobian[pos][i] * residual;
+                for (std::size_t j = 0; j <= i; ++j) {
+                    normal[i][j] += jacobian[pos][i] * jacobian[pos][j];
+                }
+            }
+        }
+        for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+            for (std::size_t j = 0; j < i; ++j) normal[j][i] = normal[i][j];
+        }
+
+        bool stop = std::all_of(gradient.begin(), gradient.end(),
+                                [](double g) { return std::abs(g) <= GRADIENT_TOLERANCE; });
+        std::array<double, NUM_PARAMETERS> step{};
+        std::array<double, NUM_PARAMETERS> trial{};
+        if (!stop) {
+            double maxDiag = 0.0;
+            for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+                maxDiag = std::max(maxDiag, normal[i][i]);
+            }
+            if (mu < 0.0) mu = 1e-3 * maxDiag;
+            // Масштабирование Марквардта: mu * diag(J^T J)
+            auto damped = normal;
+            for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+                damped[i][i] += mu * std::max(normal[i][i], 1e-12 * maxDiag);
+                step[i] = -gradient[i];
+            }
+            if (!solveCholesky(damped, step)) {
+                mu *= nu;
+                nu *= 2.0;
+                ++iteration;
+                continue;
+            }
+            // Шаг в пределах допустимой области
+            double stepNorm = 0.0;
+            double norm = 0.0;
+            for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) {
+                trial[j] = std::min(std::max(x[j] + step[j], LOWER_BOUNDS[j]), UPPER_BOUNDS[j]);
+                step[j] = trial[j] - x[j];
+                stepNorm += step[j] * step[j];
+                norm += x[j] * x[j];
+            }
+            stop = std::sqrt(stepNorm) <= STEP_TOLERANCE * (std::sqrt(norm) + STEP_TOLERANCE);
+        }
+        if (stop) {
+            // Диапазоны срезов, построенные по начальному приближению, должны покрывать решение
+            const HestonParameters current = fromArray(x);
+            const bool covered =
+                std::all_of(slices.begin(), slices.end(), [&](const HestonCOSPricer::Slice& s) {
+                    return m_pricer.covers(s, current);
+                });
+            if (covered || rebuilds == MAX_RANGE_REBUILDS) {
+                converged = true;
+                break;
+            }
+            ++rebuilds;
+            slices = makeSlices(current);
+            evaluate(current, slices, prices, &jacobian);
+            currentCost = cost(prices);
+            mu = -1.0;
+            nu = 2.0;
+            continue;
+        }
+
+        ++iteration;
+        evaluate(fromArray(trial), slices, trialPrices, &trialJacobian);
+        const double trialCost = cost(trialPrices);
+        // Предсказанное квадратичной моделью уменьшение
+        double predicted = 0.0;
+        for (std::size_t i = 0; i < NUM_PARAMETERS; ++i) {
+            double quad = 0.0;
+            for (std::size_t j = 0; j < NUM_PARAMETERS; ++j) quad += normal[i][j] * step[j];
+            predicted -= step[i] * (gradient[i] + 0.5 * quad);
+        }
+        const double ratio = (predicted > 0.0) ? (currentCost - trialCost) / predicted : -1.0;
+        if (ratio > 0.0) {
+            x = trial;
+            std::swap(prices, trialPrices);
+            std::swap(jacobian, trialJacobian);
+            currentCost = trialCost;
+            const double t = 2.0 * ratio - 1.0;
+            mu *= std::max(1.0 / 3.0, 1.0 - t * t * t);
+            nu = 2.0;
+        } else {
+            mu *= nu;
+            nu *= 2.0;
+        }
+    }
+
+    return {fromArray(x), std::sqrt(2.0 * currentCost / static_cast<double>(m)), iteration,
+            converged};
+}
+
+}  // namespace mcopt
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Analytical.hpp"
+
+/**
+ * @file Heston.hpp
+ * @brief Модель Хестона: полуаналитическая оценка COS-методом и калибровка к поверхности.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct HestonParameters
+ * @brief \f$ dS_t = r S_t dt + \sqrt{v_t} S_t dW^S_t \f$,
+ * \f$ dv_t = \kappa (\theta - v_t) dt + \sigma \sqrt{v_t} dW^v_t \f$,
+ * \f$ d\langle W^S, W^v \rangle_t = \rho\, dt \f$.
+ */
+struct HestonParameters {
+    double v0;     ///< Initial variance.
+    double kappa;  ///< Mean-reversion speed.
+    double theta;  ///< Long-run variance.
+    double sigma;  ///< Volatility of variance.
+    double rho;    ///< Spot-variance correlation.
+};
+
+/// @brief Derivatives with respect to (v0, kappa, theta, sigma, rho), in that order.
+using HestonGradient = std::array<double, 5>;
+
+/**
+ * @brief Validates Heston parameters.
+ * @throws std::invalid_argument Unless v0 >= 0, kappa > 0, theta >= 0, sigma > 0 and
+ * |rho| <= 1.
+ */
+void validateHeston(const HestonParameters& p);
+
+/**
+ * @class HestonCOSPricer
+ * @brief European options under Heston by the Fourier-cosine (COS) expansion of Fang and
+ * Oosterlee.
+ *
+ * The density of \f$ z = \log(S_T / S_0) \f$ is expanded in N cosines on
+ * \f$ [a, b] = c_1 \mp L \sqrt{c_2} \f$ (\f$ c_1, c_2 \f$ are the first two cumulants). A put is
+ * \f[
+ * P = e^{-rT} \sum_{k=0}^{N-1}{}' \mathrm{Re}\left[\varphi(u_k) e^{-i u_k a}\right] V_k(K),
+ * \qquad u_k = \frac{k \pi}{b - a},
+ * \f]
+ * with closed-form payoff coefficients \f$ V_k(K) \f$; calls follow from put-call parity. The
+ * characteristic function \f$ \varphi \f$ (in the "little trap" form, continuous in u) and its
+ * analytic parameter derivatives depend on the maturity only, so a Slice holds the
+ * coefficients of all strikes of one maturity as a strike x N matrix built once, and every
+ * evaluation is N characteristic-function values plus dense dot products.
+ */
+class HestonCOSPricer {
+   public:
+    /**
+     * @struct Slice
+     * @brief Options of one maturity with the truncation range and payoff coefficients fixed.
+     */
+    struct Slice {
+        double maturity;
+        double a;                          ///< Lower end of the range of log(S_T / S_0).
+        double b;                          ///< Upper end of the range.
+        std::vector<double> strikes;
+        std::vector<OptionType> types;
+        std::vector<double> coefficients;  ///< strikes x terms, already scaled by 2 / (b - a).
+    };
+
+    /**
+     * @param spot Spot price.
+     * @param rate Constant risk-free rate.
+     * @param terms Number of cosine terms N.
+     * @param truncation Width L of the range in standard deviations.
+     * @throws std::invalid_argument If spot <= 0, terms < 2 or truncation <= 0.
+     */
+    HestonCOSPricer(double spot, double rate, std::size_t terms = 256, double truncation = 16.0);
+
+    /**
+     * @brief Builds a slice; the range is taken from `rangeParameters`.
+     * @throws std::invalid_argument If the maturity is not positive, a strike is not positive,
+     * the sizes differ or the parameters are invalid.
+     */
+    [[nodiscard]] Slice makeSlice(double maturity, std::vector<double> strikes,
+                                  std::vector<OptionType> types,
+                                  const HestonParameters& rangeParameters) const;
+
+    /// @brief Whether the range the parameters need lies within the range of the slice.
+    [[nodiscard]] bool covers(const Slice& slice, const HestonParameters& p) const;
+
+    /**
+     * @brief Prices (and optionally gradients) of all options of a slice.
+     *
+     * The gradients are exact derivatives of the truncated expansion with the slice range
+     * held fixed.
+     * @param prices Output, one price per strike.
+     * @param gradients Optional output, one gradient per strike (may be null).
+     */
+    void evaluate(const HestonParameters& p, const Slice& slice, double* prices,
+                  HestonGradient* gradients = nullptr) const;
+
+    /// @brief Single option price (builds a one-strike slice).
+    [[nodiscard]] double price(const HestonParameters& p, double T, double K,
+                               OptionType type) const;
+
+    [[nodiscard]] double spot() const noexcept { return m_spot; }
+    [[nodiscard]] double rate() const noexcept { return m_rate; }
+
+   private:
+    /// @brief Truncation range of log(S_T / S_0).
+    void range(const HestonParameters& p, double T, double& a, double& b) const;
+
+    double m_spot;
+    double m_rate;
+    std::size_t m_terms;
+    double m_truncation;
+};
+
+/**
+ * @struct HestonQuote
+ * @brief Market price of a European option.
+ */
+struct HestonQuote {
+    double maturity;
+    double strike;
+    double price;
+    OptionType type;
+};
+
+/**
+ * @struct HestonCalibration
+ * @brief Result of HestonCalibrator::calibrate().
+ */
+struct HestonCalibration {
+    HestonParameters parameters;  ///< Fitted parameters, ready for HestonEngine.
+    double rmse;                  ///< Root-mean-square price error.
+    unsigned int iterations;      ///< Levenberg-Marquardt iterations.
+    bool converged;               ///< False if the iteration limit was hit.
+};
+
+/**
+ * @class HestonCalibrator
+ * @brief Least-squares fit of the Heston parameters to option prices.
+ *
+ * Quotes are grouped into one COS slice per maturity. Levenberg-Marquardt (Marquardt scaling,
+ * Nielsen damping update) minimises \f$ \frac12 \sum_i (P_i(p) - P_i^{mkt})^2 \f$ with the
+ * Jacobian from the analytic gradients of HestonCOSPricer; each evaluation prices the slices in
+ * parallel. Steps are clamped to the admissible box (v0, theta in [1e-6, 4], kappa in
+ * [1e-3, 50], sigma in [1e-3, 5], rho in [-0.999, 0.999]). Slice ranges are built from the
+ * initial guess and rebuilt once the iterate needs a wider range.
+ */
+class HestonCalibrator {
+   public:
+    /**
+     * @param spot Spot price.
+     * @param rate Constant risk-free rate.
+     * @param quotes Option prices (at least 5).
+     * @param terms Number of cosine terms.
+     * @throws std::invalid_argument If there are fewer than 5 quotes or a quote has a
+     * non-positive maturity or strike.
+     */
+    HestonCalibrator(double spot, double rate, std::vector<HestonQuote> quotes,
+                     std::size_t terms = 256);
+
+    /**
+     * @brief Fits the parameters starting from `initial`.
+     * @param maxIterations Iteration limit.
+     * @throws std::invalid_argument If the initial guess is invalid.
+     */
+    [[nodiscard]] HestonCalibration calibrate(const HestonParameters& initial,
+                                              unsigned int maxIterations = 200) const;
+
+    /// @brief Model prices of all quotes, in quote order.
+    [[nodiscard]] std::vector<double> modelPrices(const HestonParameters& p) const;
+
+    /// @brief Number of threads (0 = hardware concurrency).
+    void setNumThreads(unsigned int threads);
+
+   private:
+    /// @brief Quotes of one maturity: a contiguous range of m_order.
+    struct Group {
+        double maturity;
+        std::size_t offset;
+        std::size_t count;
+    };
+
+    [[nodiscard]] std::vector<HestonCOSPricer::Slice> makeSlices(
+        const HestonParameters& rangeParameters) const;
+
+    /// @brief Prices (and gradients) in m_order order, slices priced in parallel.
+    void evaluate(const HestonParameters& p, const std::vector<HestonCOSPricer::Slice>& slices,
+                  std::vector<double>& prices, std::vector<HestonGradient>* gradients) const;
+
+    HestonCOSPricer m_pricer;
+    std::vector<HestonQuote> m_quotes;
+    std::vector<std::size_t> m_order;  ///< Quote indices sorted by maturity.
+    std::vector<Group> m_groups;
+    unsigned int m_numThreads;
+};
+
+}  // namespace mcopt
@@ -0,0 +1,155 @@
+#include "HestonEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "Constants.hpp"
+#include "NormalGenerator.hpp"
+#include "RandomStream.hpp"
+
+namespace mcopt {
+
+namespace {
+
+// Пачка антитетических пар: "плюс"-пути в [0, n), зеркальные в [n, 2n)
+constexpr unsigned long long PAIR_BATCH = 128;
+
+// Порог переключения ветвей схемы QE (Andersen 2008)
+constexpr double QE_SWITCH = 1.5;
+
+}  // namespace
+
+HestonEngine::HestonEngine(std::shared_ptr<Payoff> payoff, double S0, double T, double r,
+                           HestonParameters params, uint64_t seed)
+    : m_payoff(std::move(payoff)), m_S0(S0), m_T(T), m_r(r), m_params(params), m_seed(seed) {
+    if (!m_payoff) {
+        throw std::invalid_argument("Payoff pointer cannot be null.");
+    }
+    if (!(m_S0 > 0.0) || !(m_T > 0.0)) {
+        throw std::invalid_argument("Heston engine needs S0 > 0 and T > 0.");
+    }
+    validateHeston(m_params);
+    setNumThreads(0);
+}
+
+void HestonEngine::setNumThreads(unsigned int threads) {
+    m_numThreads = resolveThreadCount(threads);
+}
+
+PricingResult HestonEngine::calculatePrice(unsigned long long numSimulations,
+                                           unsigned int numSteps) const {
+    return run(numSimulations, numSteps, false);
+}
+
+PricingResult HestonEngine::calculateAsianPrice(unsigned long long numSimulations,
+                                                unsigned int numSteps) const {
+    return run(numSimulations, numSteps, true);
+}
+
+PricingResult HestonEngine::run(unsigned long long numSimulations, unsigned int numSteps,
+                                bool average) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Heston simulation needs at least one time step.");
+    }
+    numSimulations -= numSimulations % 2;
+
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<PathStatistics> blocks(numBlocks);
+    auto simulate = [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runChunk(b, pathsInBlock(b, numSimulations), numSteps, average);
+        }
+    };
+    parallelForBlocks(numBlocks, m_numThreads, simulate);
+
+    const PathStatistics total = reduceBlocks(blocks);
+    const double discount = std::exp(-m_r * m_T);
+    return {discount * total.mean(), discount * total.standardError(), numSimulations};
+}
+
+PathStatistics HestonEngine::runChunk(unsigned long long block, unsigned long long numPaths,
+                                      unsigned int numSteps, bool average) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, STREAM_HESTON, block);
+    const NormalGenerator normals;
+    const HestonParameters& p = m_params;
+
+    // Коэффициенты шага схемы QE: общие для всех путей
+    const double h = m_T / static_cast<double>(numSteps);
+    const double decay = std::exp(-p.kappa * h);
+    const double s2v = p.sigma * p.sigma * decay * (1.0 - decay) / p.kappa;
+    const double s2c = p.theta * p.sigma * p.sigma * (1.0 - decay) * (1.0 - decay) /
+                       (2.0 * p.kappa);
+    const double k0 = -p.rho * p.kappa * p.theta * h / p.sigma + m_r * h;
+    const double k1 = 0.5 * h * (p.kappa * p.rho / p.sigma - 0.5) - p.rho / p.sigma;
+    const double k2 = 0.5 * h * (p.kappa * p.rho / p.sigma - 0.5) + p.rho / p.sigma;
+    const double k3 = 0.5 * h * (1.0 - p.rho * p.rho);
+    const double x0 = std::log(m_S0);
+
+    std::array<double, 2 * PAIR_BATCH> x{};
+    std::array<double, 2 * PAIR_BATCH> v{};
+    std::array<double, 2 * PAIR_BATCH> sumSpots{};
+    std::array<double, 2 * PAIR_BATCH> Zv{};
+    std::array<double, 2 * PAIR_BATCH> Zs{};
+    BlockAccumulator acc;
+
+    const unsigned long long pairs = numPaths / 2;
+    for (unsigned long long start = 0; start < pairs; start += PAIR_BATCH) {
+        const unsigned long long n = std::min(PAIR_BATCH, pairs - start);
+        const unsigned long long lanes = 2 * n;
+        x.fill(x0);
+        v.fill(p.v0);
+        sumSpots.fill(0.0);
+
+        for (unsigned int j = 0; j < numSteps; ++j) {
+            normals.fill(rng, Zv.data(), n);
+            normals.fill(rng, Zs.data(), n);
+            for (unsigned long long i = 0; i < n; ++i) {
+                Zv[n + i] = -Zv[i];
+                Zs[n + i] = -Zs[i];
+            }
+
+            for (unsigned long long i = 0; i < lanes; ++i) {
+                const double vOld = v[i];
+                const double m = p.theta + (vOld - p.theta) * decay;
+                const double s2 = vOld * s2v + s2c;
+                const double psi = s2 / (m * m);
+                double vNew = 0.0;
+                if (psi <= QE_SWITCH) {
+                    const double inv = 2.0 / psi;
+                    const double b2 = inv - 1.0 + std::sqrt(inv) * std::sqrt(inv - 1.0);
+                    const double b = std::sqrt(b2);
+                    vNew = m / (1.0 + b2) * (b + Zv[i]) * (b + Zv[i]);
+                } else {
+                    // Атом в нуле и экспоненциальный хвост: U = Phi(Z_v)
+                    const double mass = (psi - 1.0) / (psi + 1.0);
+                    const double u = 0.5 * std::erfc(-Zv[i] / math::SQRT2);
+                    vNew = (u <= mass) ? 0.0 : std::log((1.0 - mass) / (1.0 - u)) * m /
+                                                   (1.0 - mass);
+                }
+                x[i] += k0 + k1 * vOld + k2 * vNew + std::sqrt(k3 * (vOld + vNew)) * Zs[i];
+                v[i] = vNew;
+            }
+            if (average) {
+                for (unsigned long long i = 0; i < lanes; ++i) sumSpots[i] += std::exp(x[i]);
+            }
+        }
+
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            double plus = average ? sumSpots[i] / static_cast<double>(numSteps) : std::exp(x[i]);
+            double minus = average ? sumSpots[n + i] / static_cast<double>(numSteps)
+                                   : std::exp(x[n + i]);
+            double y = 0.5 * ((*m_payoff)(plus) + (*m_payoff)(minus));
+            batchSum += y;
+            batchSumSq += y * y;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
+    }
+    return acc.result();
+}
+
+}  // namespace mcopt
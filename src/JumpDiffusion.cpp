@@ -0,0 +1,226 @@
+#include "JumpDiffusion.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "Analytical.hpp"
+#include "NormalGenerator.hpp"
+#include "RandomStream.hpp"
+
+namespace mcopt {
+
+namespace {
+
+// Пачка антитетических пар: "плюс"-пути в [0, n), зеркальные в [n, 2n)
+constexpr unsigned long long PAIR_BATCH = 128;
+
+// Хвост распределения Пуассона, отбрасываемый при построении таблицы
+constexpr double POISSON_TAIL = 1e-16;
+constexpr std::size_t MAX_JUMPS = 1000;
+
+}  // namespace
+
+JumpDiffusionEngine::JumpDiffusionEngine(std::shared_ptr<Payoff> payoff, double S0, double T,
+                                         double r, double sigma, MertonParameters jumps,
+                                         uint64_t seed)
+    : m_payoff(std::move(payoff)),
+      m_S0(S0),
+      m_T(T),
+      m_r(r),
+      m_sigma(sigma),
+      m_jumps(jumps),
+      m_seed(seed) {
+    if (!m_payoff) {
+        throw std::invalid_argument("Payoff pointer cannot be null.");
+    }
+    if (m_S0 < 0.0 || m_T < 0.0 || m_sigma < 0.0 || m_jumps.intensity < 0.0 ||
+        m_jumps.jumpVol < 0.0) {
+        throw std::invalid_argument(
+            "Invalid jump-diffusion parameters (S0, T, sigma, intensity, jumpVol must be >= 0).");
+    }
+    setNumThreads(0);
+}
+
+void JumpDiffusionEngine::setNumThreads(unsigned int threads) {
+    m_numThreads = resolveThreadCount(threads);
+}
+
+JumpDiffusionEngine::StepModel JumpDiffusionEngine::buildStepModel(double h) const {
+    const double kappa =
+        std::exp(m_jumps.jumpMean + 0.5 * m_jumps.jumpVol * m_jumps.jumpVol) - 1.0;
+    StepModel model;
+    model.drift = (m_r - m_jumps.intensity * kappa - 0.5 * m_sigma * m_sigma) * h;
+    model.diffusion = m_sigma * std::sqrt(h);
+
+    // Кумулятивные вероятности числа скачков за шаг
+    const double mean = m_jumps.intensity * h;
+    double probability = std::exp(-mean);
+    double cumulative = probability;
+    // За модой хвост убывает быстрее геометрической прогрессии; 1 - cumulative для этого
+    // не годится — в double оно не опускается ниже ~1e-16
+    for (std::size_t k = 0; k < MAX_JUMPS; ++k) {
+        probability *= mean / static_cast<double>(k + 1);
+        if (static_cast<double>(k + 1) > mean && probability < POISSON_TAIL) break;
+        model.cumulative.push_back(cumulative);
+        cumulative += probability;
+    }
+    // Число скачков = число порогов ниже u, от 0 до cumulative.size()
+    for (std::size_t k = 0; k <= model.cumulative.size(); ++k) {
+        model.jumpDrift.push_back(static_cast<double>(k) * m_jumps.jumpMean);
+        model.jumpScale.push_back(std::sqrt(static_cast<double>(k)) * m_jumps.jumpVol);
+    }
+    return model;
+}
+
+JumpDiffusionEngine::BlockSums JumpDiffusionEngine::runChunk(unsigned long long block,
+                                                             unsigned long long numPaths,
+                                                             unsigned int numSteps,
+                                                             const StepModel& model) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, STREAM_JUMP_DIFFUSION, block);
+    const NormalGenerator normals;
+
+    const bool average = numSteps > 0;
+    const unsigned int steps = average ? numSteps : 1;
+    const double x0 = std::log(m_S0);
+    const double strike = m_payoff->strike();
+    const std::size_t thresholds = model.cumulative.size();
+
+    std::array<double, 2 * PAIR_BATCH> x{};
+    std::array<double, 2 * PAIR_BATCH> sumSpots{};
+    std::array<double, PAIR_BATCH> Z{};
+    std::array<double, PAIR_BATCH> U{};
+    std::array<double, PAIR_BATCH> jumpNoise{};
+    std::array<std::size_t, PAIR_BATCH> counts{};
+    BlockSums sums;
+    BlockAccumulator acc;
+
+    const unsigned long long pairs = numPaths / 2;
+    for (unsigned long long start = 0; start < pairs; start += PAIR_BATCH) {
+        const unsigned long long n = std::min(PAIR_BATCH, pairs - start);
+        x.fill(x0);
+        sumSpots.fill(0.0);
+
+        for (unsigned int j = 0; j < steps; ++j) {
+            normals.fill(rng, Z.data(), n);
+            for (unsigned long long i = 0; i < n; ++i) U[i] = NormalGenerator::uniform(rng());
+
+            // Число скачков всей пачки: сравнение с таблицей без ветвлений
+            counts.fill(0);
+            for (std::size_t k = 0; k < thresholds; ++k) {
+                const double level = model.cumulative[k];
+                for (unsigned long long i = 0; i < n; ++i) {
+                    counts[i] += static_cast<std::size_t>(U[i] > level);
+                }
+            }
+            // Нормали размера скачка — только для путей, где скачки были
+            for (unsigned long long i = 0; i < n; ++i) {
+                jumpNoise[i] = (counts[i] > 0) ? model.jumpScale[counts[i]] * normals(rng) : 0.0;
+            }
+
+            for (unsigned long long i = 0; i < n; ++i) {
+                const double base = model.drift + model.jumpDrift[counts[i]];
+                const double shock = model.diffusion * Z[i] + jumpNoise[i];
+                x[i] += base + shock;
+                x[n + i] += base - shock;
+            }
+            if (average) {
+                for (unsigned long long i = 0; i < 2 * n; ++i) sumSpots[i] += std::exp(x[i]);
+            }
+        }
+
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            const double plusT = std::exp(x[i]);
+            const double minusT = std::exp(x[n + i]);
+            double y = 0.0;
+            if (average) {
+                const double scale = 1.0 / static_cast<double>(steps);
+                y = 0.5 *
+                    ((*m_payoff)(sumSpots[i] * scale) + (*m_payoff)(sumSpots[n + i] * scale));
+                // Контрольная переменная: европейский колл на S_T
+                const double c =
+                    0.5 * (std::max(plusT - strike, 0.0) + std::max(minusT - strike, 0.0));
+                sums.sumX += c;
+                sums.sumXX += c * c;
+                sums.sumXY += c * y;
+            } else {
+                y = 0.5 * ((*m_payoff)(plusT) + (*m_payoff)(minusT));
+            }
+            batchSum += y;
+            batchSumSq += y * y;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
+    }
+    sums.payoff = acc.result();
+    return sums;
+}
+
+std::vector<JumpDiffusionEngine::BlockSums> JumpDiffusionEngine::runBlocks(
+    unsigned long long numSimulations, unsigned int numSteps, const StepModel& model) const {
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<BlockSums> blocks(numBlocks);
+    auto simulate = [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runChunk(b, pathsInBlock(b, numSimulations), numSteps, model);
+        }
+    };
+    parallelForBlocks(numBlocks, m_numThreads, simulate);
+    return blocks;
+}
+
+PricingResult JumpDiffusionEngine::calculatePrice(unsigned long long numSimulations) const {
+    numSimulations -= numSimulations % 2;
+    const StepModel model = buildStepModel(m_T);
+    PathStatistics total;
+    for (const BlockSums& b : runBlocks(numSimulations, 0, model)) total.merge(b.payoff);
+    const double discount = std::exp(-m_r * m_T);
+    return {discount * total.mean(), discount * total.standardError(), numSimulations};
+}
+
+PricingResult JumpDiffusionEngine::calculateAsianPrice(unsigned long long numSimulations,
+                                                       unsigned int numSteps,
+                                                       bool controlVariate) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
+    }
+    numSimulations -= numSimulations % 2;
+    const StepModel model = buildStepModel(m_T / static_cast<double>(numSteps));
+
+    // Свертка в порядке блоков
+    BlockSums total;
+    for (const BlockSums& b : runBlocks(numSimulations, numSteps, model)) {
+        total.payoff.merge(b.payoff);
+        total.sumX += b.sumX;
+        total.sumXX += b.sumXX;
+        total.sumXY += b.sumXY;
+    }
+    const double discount = std::exp(-m_r * m_T);
+    const PathStatistics& y = total.payoff;
+    // Без страйка (Payoff::strike() = NaN) контрольной переменной нет
+    if (!controlVariate || y.count < 2 || !std::isfinite(m_payoff->strike())) {
+        return {discount * y.mean(), discount * y.standardError(), numSimulations};
+    }
+
+    // Регрессионная оценка beta и дисперсия остатка Y - beta X
+    const auto n = static_cast<double>(y.count);
+    const double meanX = total.sumX / n;
+    const double meanY = y.mean();
+    const double varX = (total.sumXX - n * meanX * meanX) / (n - 1.0);
+    const double covXY = (total.sumXY - n * meanX * meanY) / (n - 1.0);
+    const double beta = (varX > 0.0) ? covXY / varX : 0.0;
+    const double controlMean =
+        BlackScholesAnalytical::calculateMerton(m_S0, m_payoff->strike(), m_T, m_r, m_sigma,
+                                                m_jumps.intensity, m_jumps.jumpMean,
+                                                m_jumps.jumpVol, OptionType::Call)
+            .price /
+        discount;
+    const double residual = std::max(y.variance() - 2.0 * beta * covXY + beta * beta * varX, 0.0);
+    return {discount * (meanY - beta * (meanX - controlMean)), discount * std::sqrt(residual / n),
+            numSimulations};
+}
+
+}  // namespace mcopt
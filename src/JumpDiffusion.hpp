@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Payoff.hpp"
+#include "Statistics.hpp"
+
+/**
+ * @file JumpDiffusion.hpp
+ * @brief Движок Монте-Карло в модели скачкообразной диффузии Мертона.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct MertonParameters
+ * @brief Jump part of the Merton model: Poisson arrivals with normal log-jumps.
+ */
+struct MertonParameters {
+    double intensity;  ///< \f$ \lambda \f$, expected number of jumps per year.
+    double jumpMean;   ///< \f$ \mu_J \f$, mean of the log-jump.
+    double jumpVol;    ///< \f$ \delta_J \f$, standard deviation of the log-jump.
+};
+
+/**
+ * @class JumpDiffusionEngine
+ * @brief Monte Carlo engine for the Merton jump-diffusion model
+ * \f$ dS_t / S_{t-} = (r - \lambda\kappa) dt + \sigma dW_t + (e^J - 1) dN_t \f$.
+ *
+ * Given the number of jumps n in an interval, their total log size is
+ * \f$ N(n \mu_J, n \delta_J^2) \f$, so the log-spot over an interval of length h is sampled
+ * exactly from one diffusion normal, one Poisson count and (only if n > 0) one jump normal:
+ * - European pricing takes a single step to maturity.
+ * - Path-dependent pricing takes equal steps; the Poisson counts of a whole batch of paths
+ *   are sampled at once per step by inversion against a precomputed cumulative table (a
+ *   branch-free count over the table), and jump normals are drawn only for the paths that
+ *   jumped.
+ *
+ * Paths are simulated in antithetic pairs (diffusion and jump normals mirrored, same counts),
+ * one sample per pair, in RNG blocks of `PATHS_PER_BLOCK` paths reduced in block order, so
+ * results do not depend on the number of threads.
+ */
+class JumpDiffusionEngine {
+   public:
+    /**
+     * @param payoff Payoff of the terminal spot (European) or of the average (Asian).
+     * @param S0 Initial spot.
+     * @param T Maturity.
+     * @param r Risk-free rate.
+     * @param sigma Diffusion volatility.
+     * @param jumps Jump parameters.
+     * @param seed Random seed.
+     * @throws std::invalid_argument If the payoff is null or S0, T, sigma, the intensity or the
+     * jump volatility is negative.
+     */
+    JumpDiffusionEngine(std::shared_ptr<Payoff> payoff, double S0, double T, double r,
+                        double sigma, MertonParameters jumps, uint64_t seed = 42);
+
+    /**
+     * @brief European price from a single terminal step.
+     * @param numSimulations Number of paths (rounded down to whole pairs).
+     */
+    [[nodiscard]] PricingResult calculatePrice(unsigned long long numSimulations) const;
+
+    /**
+     * @brief Asian price with per-step Poisson jumps.
+     *
+     * With `controlVariate` the European call on \f$ S_T \f$ at the payoff's strike, whose
+     * price is known from BlackScholesAnalytical::calculateMerton(), is used as a control
+     * variate: \f$ \hat V = \bar Y - \hat\beta (\bar X - E[X]) \f$ with the regression
+     * coefficient \f$ \hat\beta \f$ estimated from the same paths.
+     *
+     * @param numSimulations Number of paths (rounded down to whole pairs).
+     * @param numSteps Number of monitoring steps.
+     * @param controlVariate Apply the European control variate (ignored if the payoff has no
+     * strike).
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    [[nodiscard]] PricingResult calculateAsianPrice(unsigned long long numSimulations,
+                                                    unsigned int numSteps,
+                                                    bool controlVariate = true) const;
+
+    /// @brief Number of threads (0 = hardware concurrency).
+    void setNumThreads(unsigned int threads);
+
+   private:
+    /// @brief Undiscounted per-block sums: payoff Y and European control X.
+    struct BlockSums {
+        PathStatistics payoff;
+        double sumX = 0.0;
+        double sumXX = 0.0;
+        double sumXY = 0.0;
+    };
+
+    /// @brief Coefficients of one time step of length h.
+    struct StepModel {
+        double drift;                     ///< \f$ (r - \lambda\kappa - \sigma^2/2) h \f$.
+        double diffusion;                 ///< \f$ \sigma \sqrt h \f$.
+        std::vector<double> cumulative;   ///< \f$ P(N_h \le k) \f$, k = 0, 1, ...
+        std::vector<double> jumpDrift;    ///< \f$ k \mu_J \f$.
+        std::vector<double> jumpScale;    ///< \f$ \sqrt k \delta_J \f$.
+    };
+
+    [[nodiscard]] StepModel buildStepModel(double h) const;
+
+    [[nodiscard]] BlockSums runChunk(unsigned long long block, unsigned long long numPaths,
+                                     unsigned int numSteps, const StepModel& model) const;
+
+    [[nodiscard]] std::vector<BlockSums> runBlocks(unsigned long long numSimulations,
+                                                   unsigned int numSteps,
+                                                   const StepModel& model) const;
+
+    std::shared_ptr<Payoff> m_payoff;
+    double m_S0;
+    double m_T;
+    double m_r;
+    double m_sigma;
+    MertonParameters m_jumps;
+    uint64_t m_seed;
+    unsigned int m_numThreads;
+};
+
+}  // namespace mcopt
@@ -0,0 +1,138 @@
+#include "LocalVolEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "NormalGenerator.hpp"
+#include "RandomStream.hpp"
+
+namespace mcopt {
+
+namespace {
+
+// Пачка антитетических пар: Z и -Z идут в двух половинах массивов
+constexpr unsigned long long PAIR_BATCH = 128;
+
+}  // namespace
+
+LocalVolEngine::LocalVolEngine(std::shared_ptr<Payoff> payoff, double S0, double T,
+                               std::shared_ptr<const LocalVolSurface> surface, uint64_t seed)
+    : m_payoff(std::move(payoff)),
+      m_S0(S0),
+      m_T(T),
+      m_r(0.0),
+      m_surface(std::move(surface)),
+      m_seed(seed) {
+    if (!m_payoff || !m_surface) {
+        throw std::invalid_argument("Payoff and local vol surface cannot be null.");
+    }
+    m_r = m_surface->rate();  // Ставка, с которой построена таблица Дюпира
+    if (!(m_S0 > 0.0) || !(m_T > 0.0) || m_T > m_surface->maturity()) {
+        throw std::invalid_argument(
+            "Local vol engine needs S0 > 0 and 0 < T <= surface maturity.");
+    }
+    setNumThreads(0);
+}
+
+void LocalVolEngine::setNumThreads(unsigned int threads) {
+    m_numThreads = resolveThreadCount(threads);
+}
+
+PricingResult LocalVolEngine::calculatePrice(unsigned long long numSimulations,
+                                             unsigned int numSteps) const {
+    return run(numSimulations, numSteps, false);
+}
+
+PricingResult LocalVolEngine::calculateAsianPrice(unsigned long long numSimulations,
+                                                  unsigned int numSteps) const {
+    return run(numSimulations, numSteps, true);
+}
+
+PricingResult LocalVolEngine::run(unsigned long long numSimulations, unsigned int numSteps,
+                                  bool average) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Local vol simulation needs at least one time step.");
+    }
+    numSimulations -= numSimulations % 2;
+
+    // Строки таблицы на моменты t_j — один раз на расчет, подряд в памяти
+    const double dt = m_T / static_cast<double>(numSteps);
+    const std::size_t rowSize = m_surface->rowSize();
+    std::vector<double> rows(numSteps * rowSize);
+    for (unsigned int j = 0; j < numSteps; ++j) {
+        m_surface->slice(dt * static_cast<double>(j), rows.data() + j * rowSize);
+    }
+
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<PathStatistics> blocks(numBlocks);
+    auto simulate = [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runChunk(b, pathsInBlock(b, numSimulations), numSteps, average, rows);
+        }
+    };
+    parallelForBlocks(numBlocks, m_numThreads, simulate);
+
+    const PathStatistics total = reduceBlocks(blocks);
+    const double discount = std::exp(-m_r * m_T);
+    return {discount * total.mean(), discount * total.standardError(), numSimulations};
+}
+
+PathStatistics LocalVolEngine::runChunk(unsigned long long block, unsigned long long numPaths,
+                                        unsigned int numSteps, bool average,
+                                        const std::vector<double>& rows) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, STREAM_LOCAL_VOL, block);
+    const NormalGenerator normals;
+    const LocalVolSurface& surface = *m_surface;
+
+    const double dt = m_T / static_cast<double>(numSteps);
+    const double sqrtDt = std::sqrt(dt);
+    const double rateDrift = m_r * dt;
+    const double x0 = std::log(m_S0);
+    const std::size_t rowSize = surface.rowSize();
+
+    std::array<double, 2 * PAIR_BATCH> x{};
+    std::array<double, 2 * PAIR_BATCH> sumSpots{};
+    std::array<double, 2 * PAIR_BATCH> Z{};
+    BlockAccumulator acc;
+
+    const unsigned long long pairs = numPaths / 2;
+    for (unsigned long long start = 0; start < pairs; start += PAIR_BATCH) {
+        const unsigned long long n = std::min(PAIR_BATCH, pairs - start);
+        const unsigned long long lanes = 2 * n;
+        x.fill(x0);
+        sumSpots.fill(0.0);
+
+        for (unsigned int j = 0; j < numSteps; ++j) {
+            normals.fill(rng, Z.data(), n);
+            for (unsigned long long i = 0; i < n; ++i) Z[n + i] = -Z[i];
+
+            // Поиск в строке шага и шаг Эйлера по лог-споту — один цикл по всей пачке
+            const double* row = rows.data() + j * rowSize;
+            for (unsigned long long i = 0; i < lanes; ++i) {
+                double vol = surface.lookup(row, x[i]);
+                x[i] += rateDrift - 0.5 * vol * vol * dt + vol * sqrtDt * Z[i];
+            }
+            if (average) {
+                for (unsigned long long i = 0; i < lanes; ++i) sumSpots[i] += std::exp(x[i]);
+            }
+        }
+
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            double plus = average ? sumSpots[i] / static_cast<double>(numSteps) : std::exp(x[i]);
+            double minus = average ? sumSpots[n + i] / static_cast<double>(numSteps)
+                                   : std::exp(x[n + i]);
+            double y = 0.5 * ((*m_payoff)(plus) + (*m_payoff)(minus));
+            batchSum += y;
+            batchSumSq += y * y;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
+    }
+    return acc.result();
+}
+
+}  // namespace mcopt
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "LocalVolatility.hpp"
+#include "Payoff.hpp"
+#include "Statistics.hpp"
+
+/**
+ * @file LocalVolEngine.hpp
+ * @brief Движок Монте-Карло в модели локальной волатильности.
+ */
+
+namespace mcopt {
+
+/**
+ * @class LocalVolEngine
+ * @brief Monte Carlo engine for \f$ dS_t = r S_t dt + \sigma_{loc}(t, S_t) S_t dW_t \f$.
+ *
+ * The rate \f$ r \f$ is the one the surface was built with (`LocalVolSurface::rate()`): a
+ * Dupire table reprices its input quotes only under that drift and discounting.
+ *
+ * Log-Euler scheme on an equally spaced grid: step j evolves
+ * \f$ x = \log S \f$ by \f$ (r - \sigma_j^2 / 2) dt + \sigma_j \sqrt{dt} Z \f$ with
+ * \f$ \sigma_j = \sigma_{loc}(t_j, S_{t_j}) \f$. The time interpolation of the table is done once
+ * per step for the whole run (one row per step, built once per pricing call); in the path loop
+ * a batch of paths does one branch-free linear lookup per path and step.
+ *
+ * Paths are simulated in antithetic pairs (one sample per pair) in RNG blocks of
+ * `PATHS_PER_BLOCK` paths with their own streams, reduced in block order, so results do not
+ * depend on the number of threads. Always runs in double precision.
+ */
+class LocalVolEngine {
+   public:
+    /**
+     * @param payoff Payoff applied to the terminal spot or to the arithmetic average.
+     * @param S0 Initial spot.
+     * @param T Maturity (at most the surface maturity).
+     * @param surface Tabulated local volatility; also sets the risk-free rate.
+     * @param seed Random seed.
+     * @throws std::invalid_argument If the payoff or surface is null, S0 <= 0, T <= 0 or T
+     * exceeds the surface maturity.
+     */
+    LocalVolEngine(std::shared_ptr<Payoff> payoff, double S0, double T,
+                   std::shared_ptr<const LocalVolSurface> surface, uint64_t seed = 42);
+
+    /**
+     * @brief European price: payoff of the terminal spot.
+     * @param numSimulations Number of paths (rounded down to whole pairs).
+     * @param numSteps Time steps to maturity.
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    [[nodiscard]] PricingResult calculatePrice(unsigned long long numSimulations,
+                                               unsigned int numSteps) const;
+
+    /**
+     * @brief Asian price: payoff of the average over \f$ t_1, \dots, t_N \f$.
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    [[nodiscard]] PricingResult calculateAsianPrice(unsigned long long numSimulations,
+                                                    unsigned int numSteps) const;
+
+    /// @brief Number of threads (0 = hardware concurrency).
+    void setNumThreads(unsigned int threads);
+
+   private:
+    [[nodiscard]] PricingResult run(unsigned long long numSimulations, unsigned int numSteps,
+                                    bool average) const;
+
+    /**
+     * @brief Simulates one RNG block.
+     * @param rows Local vol rows of all steps (numSteps x rowSize()), built by run().
+     * @return Undiscounted statistics of the block (one sample per pair).
+     */
+    [[nodiscard]] PathStatistics runChunk(unsigned long long block, unsigned long long numPaths,
+                                          unsigned int numSteps, bool average,
+                                          const std::vector<double>& rows) const;
+
+    std::shared_ptr<Payoff> m_payoff;
+    double m_S0;
+    double m_T;
+    double m_r;
+    std::shared_ptr<const LocalVolSurface> m_surface;
+    uint64_t m_seed;
+    unsigned int m_numThreads;
+};
+
+}  // namespace mcopt
@@ -0,0 +1,224 @@
+#include "LocalVolatility.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace mcopt {
+
+namespace {
+
+// Границы локальной волатильности и минимальный знаменатель формулы Дюпира
+constexpr double MIN_LOCAL_VOL = 1e-3;
+constexpr double MAX_LOCAL_VOL = 5.0;
+constexpr double MIN_DENOMINATOR = 1e-3;
+
+bool strictlyIncreasingPositive(const std::vector<double>& v) {
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        if (!(v[i] > 0.0) || (i > 0 && !(v[i] > v[i - 1]))) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+void ImpliedVolSurface::Pillar::evaluate(double at, double& value, double& first,
+                                         double& curvature) const noexcept {
+    const std::size_t n = y.size();
+    if (at <= y.front() || at >= y.back()) {
+        // Плоская подразумеваемая волатильность за пределами котировок
+        value = (at <= y.front()) ? w.front() : w.back();
+        first = 0.0;
+        curvature = 0.0;
+        return;
+    }
+    auto k = static_cast<std::size_t>(std::upper_bound(y.begin(), y.end(), at) - y.begin());
+    k = std::min(k, n - 1);
+    const double h = y[k] - y[k - 1];
+    const double a = (y[k] - at) / h;
+    const double b = (at - y[k - 1]) / h;
+    value = a * w[k - 1] + b * w[k] +
+            ((a * a * a - a) * second[k - 1] + (b * b * b - b) * second[k]) * h * h / 6.0;
+    first = (w[k] - w[k - 1]) / h +
+            ((1.0 - 3.0 * a * a) * second[k - 1] + (3.0 * b * b - 1.0) * second[k]) * h / 6.0;
+    curvature = a * second[k - 1] + b * second[k];
+}
+
+ImpliedVolSurface::ImpliedVolSurface(double spot, double rate, std::vector<double> maturities,
+                                     std::vector<double> strikes,
+                                     std::vector<std::vector<double>> vols)
+    : m_spot(spot), m_rate(rate) {
+    if (!(spot > 0.0) || maturities.empty() || strikes.size() < 3 ||
+        vols.size() != maturities.size()) {
+        throw std::invalid_argument(
+            "Implied vol surface needs a positive spot, one vol row per maturity and at least "
+            "3 strikes.");
+    }
+    if (!strictlyIncreasingPositive(maturities) || !strictlyIncreasingPositive(strikes)) {
+        throw std::invalid_argument("Maturities and strikes must be positive and increasing.");
+    }
+
+    const std::size_t n = strikes.size();
+    for (std::size_t i = 0; i < maturities.size(); ++i) {
+        if (vols[i].size() != n) {
+            throw std::invalid_argument("Each vol row must have one value per strike.");
+        }
+        Pillar p;
+        p.maturity = maturities[i];
+        p.y.resize(n);
+        p.w.resize(n);
+        const double forward = spot * std::exp(rate * p.maturity);
+        for (std::size_t j = 0; j < n; ++j) {
+            if (!(vols[i][j] > 0.0)) {
+                throw std::invalid_argument("Implied vols must be positive.");
+            }
+            p.y[j] = std::log(strikes[j] / forward);
+            p.w[j] = vols[i][j] * vols[i][j] * p.maturity;
+        }
+
+        // Естественный кубический сплайн: трехдиагональная система (алгоритм прогонки)
+        p.second.assign(n, 0.0);
+        std::vector<double> diag(n, 0.0);
+        std::vector<double> rhs(n, 0.0);
+        for (std::size_t j = 1; j + 1 < n; ++j) {
+            double hl = p.y[j] - p.y[j - 1];
+            double hr = p.y[j + 1] - p.y[j];
+            double slope = (p.w[j + 1] - p.w[j]) / hr - (p.w[j] - p.w[j - 1]) / hl;
+            double lower = (j > 1) ? hl / 6.0 : 0.0;
+            diag[j] = (hl + hr) / 3.0;
+            rhs[j] = slope;
+            if (j > 1) {
+                double m = lower / diag[j - 1];
+                diag[j] -= m * hl / 6.0;
+                rhs[j] -= m * rhs[j - 1];
+            }
+        }
+        for (std::size_t j = n - 2; j >= 1; --j) {
+            double upper = (j + 2 < n) ? (p.y[j + 1] - p.y[j]) / 6.0 : 0.0;
+            p.second[j] = (rhs[j] - upper * p.second[j + 1]) / diag[j];
+        }
+        m_pillars.push_back(std::move(p));
+    }
+}
+
+ImpliedVolSurface::Variance ImpliedVolSurface::totalVariance(double t,
+                                                             double y) const noexcept {
+    Variance v{};
+    const Pillar& first = m_pillars.front();
+    const Pillar& last = m_pillars.back();
+    double w0 = 0.0;
+    double d0 = 0.0;
+    double c0 = 0.0;
+
+    if (t <= first.maturity || m_pillars.size() == 1 || t >= last.maturity) {
+        // До первой опоры — w растет линейно от нуля, после последней — плоская волатильность
+        const Pillar& p = (t <= first.maturity) ? first : last;
+        p.evaluate(y, w0, d0, c0);
+        double scale = t / p.maturity;
+        return {w0 * scale, w0 / p.maturity, d0 * scale, c0 * scale};
+    }
+
+    std::size_t k = 1;
+    while (m_pillars[k].maturity < t) ++k;
+    const Pillar& left = m_pillars[k - 1];
+    const Pillar& right = m_pillars[k];
+    double w1 = 0.0;
+    double d1 = 0.0;
+    double c1 = 0.0;
+    left.evaluate(y, w0, d0, c0);
+    right.evaluate(y, w1, d1, c1);
+    const double span = right.maturity - left.maturity;
+    const double b = (t - left.maturity) / span;
+    const double a = 1.0 - b;
+    v.w = a * w0 + b * w1;
+    v.dwdt = (w1 - w0) / span;
+    v.dwdy = a * d0 + b * d1;
+    v.d2wdy2 = a * c0 + b * c1;
+    return v;
+}
+
+double ImpliedVolSurface::impliedVol(double T, double K) const noexcept {
+    const double y = std::log(K / (m_spot * std::exp(m_rate * T)));
+    return std::sqrt(totalVariance(T, y).w / T);
+}
+
+double ImpliedVolSurface::localVariance(double t, double S) const noexcept {
+    const double y = std::log(S / (m_spot * std::exp(m_rate * t)));
+    const Variance v = totalVariance(t, y);
+    const double ratio = y / v.w;
+    double denominator = 1.0 - ratio * v.dwdy +
+                         0.25 * (-0.25 - 1.0 / v.w + ratio * ratio) * v.dwdy * v.dwdy +
+                         0.5 * v.d2wdy2;
+    denominator = std::max(denominator, MIN_DENOMINATOR);
+    double variance = std::max(v.dwdt, 0.0) / denominator;
+    return std::min(std::max(variance, MIN_LOCAL_VOL * MIN_LOCAL_VOL),
+                    MAX_LOCAL_VOL * MAX_LOCAL_VOL);
+}
+
+LocalVolSurface::LocalVolSurface(const ImpliedVolSurface& implied, double maturity,
+                                 std::size_t spotPoints, std::size_t timePoints,
+                                 double widthStdDevs)
+    : m_spotPoints(spotPoints),
+      m_timePoints(timePoints),
+      m_maturity(maturity),
+      m_rate(implied.rate()) {
+    if (!(maturity > 0.0) || spotPoints < 2 || timePoints < 1 || !(widthStdDevs > 0.0)) {
+        throw std::invalid_argument(
+            "Local vol grid needs a positive maturity and width, >= 2 spot and >= 1 time points.");
+    }
+
+    // Диапазон лог-спота: форвард +- width стандартных отклонений ATM на погашении
+    const double logSpot = std::log(implied.spot());
+    const double center = logSpot + implied.rate() * maturity;
+    const double atmVol = implied.impliedVol(maturity, std::exp(center));
+    const double halfWidth = widthStdDevs * atmVol * std::sqrt(maturity);
+    m_logSpotMin = std::min(center, logSpot) - halfWidth;
+    const double logSpotMax = std::max(center, logSpot) + halfWidth;
+    const double logSpotStep = (logSpotMax - m_logSpotMin) / static_cast<double>(spotPoints - 1);
+    m_invLogSpotStep = 1.0 / logSpotStep;
+    m_lastIndex = static_cast<double>(spotPoints - 1);
+    const double timeStep = maturity / static_cast<double>(timePoints);
+    m_invTimeStep = 1.0 / timeStep;
+
+    // Строки и столбцы дополнены копией последнего значения: индекс i + 1 всегда допустим
+    const std::size_t rows = timePoints + 2;
+    const std::size_t cols = rowSize();
+    m_table.resize(rows * cols);
+    for (std::size_t k = 0; k <= timePoints; ++k) {
+        // В t = 0 формула вырождена: берем середину первого интервала
+        double t = std::max(static_cast<double>(k) * timeStep, 0.5 * timeStep);
+        double* row = m_table.data() + k * cols;
+        for (std::size_t i = 0; i < spotPoints; ++i) {
+            double x = m_logSpotMin + static_cast<double>(i) * logSpotStep;
+            row[i] = std::sqrt(implied.localVariance(t, std::exp(x)));
+        }
+        row[spotPoints] = row[spotPoints - 1];
+    }
+    std::copy(m_table.begin() + static_cast<std::ptrdiff_t>(timePoints * cols),
+              m_table.begin() + static_cast<std::ptrdiff_t>((timePoints + 1) * cols),
+              m_table.begin() + static_cast<std::ptrdiff_t>((timePoints + 1) * cols));
+}
+
+void LocalVolSurface::slice(double t, double* row) const noexcept {
+    double f = std::min(std::max(t * m_invTimeStep, 0.0), static_cast<double>(m_timePoints));
+    auto k = static_cast<std::size_t>(f);
+    double weight = f - static_cast<double>(k);
+    const double* lower = m_table.data() + k * rowSize();
+    const double* upper = lower + rowSize();
+    for (std::size_t i = 0; i < rowSize(); ++i) {
+        row[i] = lower[i] + weight * (upper[i] - lower[i]);
+    }
+}
+
+double LocalVolSurface::operator()(double t, double S) const noexcept {
+    double ft = std::min(std::max(t * m_invTimeStep, 0.0), static_cast<double>(m_timePoints));
+    auto k = static_cast<std::size_t>(ft);
+    double weight = ft - static_cast<double>(k);
+    const double* lower = m_table.data() + k * rowSize();
+    const double x = std::log(S);
+    double a = lookup(lower, x);
+    double b = lookup(lower + rowSize(), x);
+    return a + weight * (b - a);
+}
+
+}  // namespace mcopt
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file LocalVolatility.hpp
+ * @brief Поверхность подразумеваемой волатильности и табулированная локальная волатильность
+ * Дюпира.
+ */
+
+namespace mcopt {
+
+/**
+ * @class ImpliedVolSurface
+ * @brief Implied volatility quotes on a (maturity x strike) grid with arbitrage-aware
+ * interpolation in total variance.
+ *
+ * Each maturity pillar holds a natural cubic spline of the total variance
+ * \f$ w = \sigma_{imp}^2 T \f$ in log-moneyness \f$ y = \log(K / F_T) \f$ with
+ * \f$ F_T = S_0 e^{rT} \f$; outside the quoted strikes the implied vol is flat. Between pillars
+ * \f$ w \f$ is linear in T at fixed y; before the first pillar \f$ w \f$ grows linearly from 0
+ * and after the last the implied vol is flat.
+ */
+class ImpliedVolSurface {
+   public:
+    /**
+     * @param spot Spot price \f$ S_0 \f$.
+     * @param rate Constant risk-free rate (defines the forwards).
+     * @param maturities Strictly increasing positive pillar maturities.
+     * @param strikes Strictly increasing positive strikes (at least 3).
+     * @param vols Implied vols, one row per maturity, one column per strike.
+     * @throws std::invalid_argument If the grid is malformed or a vol is not positive.
+     */
+    ImpliedVolSurface(double spot, double rate, std::vector<double> maturities,
+                      std::vector<double> strikes, std::vector<std::vector<double>> vols);
+
+    /// @brief Interpolated implied volatility.
+    [[nodiscard]] double impliedVol(double T, double K) const noexcept;
+
+    /**
+     * @brief Dupire local variance \f$ \sigma_{loc}^2(t, S) \f$.
+     *
+     * \f[
+     * \sigma_{loc}^2 = \frac{\partial_T w}{1 - \frac{y}{w} \partial_y w
+     *   + \frac14 \left(-\frac14 - \frac1w + \frac{y^2}{w^2}\right) (\partial_y w)^2
+     *   + \frac12 \partial_y^2 w}
+     * \f]
+     * evaluated at \f$ T = t, K = S \f$. Quotes with calendar or butterfly arbitrage make the
+     * numerator or the denominator non-positive; both are floored and the result is clamped to
+     * the vol range [0.1%, 500%].
+     */
+    [[nodiscard]] double localVariance(double t, double S) const noexcept;
+
+    /// @brief Spot price of the quotes.
+    [[nodiscard]] double spot() const noexcept { return m_spot; }
+    /// @brief Risk-free rate of the quotes.
+    [[nodiscard]] double rate() const noexcept { return m_rate; }
+
+   private:
+    /// @brief Total variance and its derivatives at one point.
+    struct Variance {
+        double w;
+        double dwdt;
+        double dwdy;
+        double d2wdy2;
+    };
+
+    /// @brief Natural cubic spline of one pillar in log-moneyness.
+    struct Pillar {
+        double maturity;
+        std::vector<double> y;       ///< Log-moneyness nodes.
+        std::vector<double> w;       ///< Total variance at the nodes.
+        std::vector<double> second;  ///< Spline second derivatives at the nodes.
+
+        /// @brief w, dw/dy and d2w/dy2 at y (flat outside the nodes).
+        void evaluate(double at, double& value, double& first, double& curvature) const noexcept;
+    };
+
+    [[nodiscard]] Variance totalVariance(double t, double y) const noexcept;
+
+    double m_spot;
+    double m_rate;
+    std::vector<Pillar> m_pillars;
+};
+
+/**
+ * @class LocalVolSurface
+ * @brief Dupire local volatility tabulated on a regular (time x log-spot) grid.
+ *
+ * The surface is evaluated once at construction; lookups are bilinear and branch-free
+ * (indices come from clamped fractional positions), so they cost a few flops and two loads
+ * and can run over a whole batch of paths in one vectorisable loop. For a simulation grid the
+ * time interpolation is hoisted out of the path loop: slice() produces the log-spot row of a
+ * time step once and lookup() interpolates within it. The rate of the quotes is kept with the
+ * table: the local vols reprice the quotes only under that drift.
+ */
+class LocalVolSurface {
+   public:
+    /**
+     * @param implied Implied vol quotes.
+     * @param maturity Last time covered by the table.
+     * @param spotPoints Number of log-spot nodes.
+     * @param timePoints Number of time intervals.
+     * @param widthStdDevs Half-width of the log-spot range in ATM standard deviations at
+     * maturity.
+     * @throws std::invalid_argument If maturity <= 0, spotPoints < 2 or timePoints < 1.
+     */
+    LocalVolSurface(const ImpliedVolSurface& implied, double maturity,
+                    std::size_t spotPoints = 256, std::size_t timePoints = 128,
+                    double widthStdDevs = 5.0);
+
+    /// @brief Bilinearly interpolated local volatility (clamped to the grid).
+    [[nodiscard]] double operator()(double t, double S) const noexcept;
+
+    /// @brief Writes the log-spot row at time t (rowSize() values) to `row`.
+    void slice(double t, double* row) const noexcept;
+
+    /// @brief Linear interpolation in log-spot x = log(S) within a row from slice().
+    [[nodiscard]] double lookup(const double* row, double x) const noexcept {
+        double f = std::min(std::max((x - m_logSpotMin) * m_invLogSpotStep, 0.0), m_lastIndex);
+        auto i = static_cast<std::size_t>(f);
+        double weight = f - static_cast<double>(i);
+        return row[i] + weight * (row[i + 1] - row[i]);
+    }
+
+    /// @brief Number of values in a row (spot nodes plus one padding value).
+    [[nodiscard]] std::size_t rowSize() const noexcept { return m_spotPoints + 1; }
+    /// @brief Last time covered by the table.
+    [[nodiscard]] double maturity() const noexcept { return m_maturity; }
+    /// @brief Risk-free rate of the implied vol quotes the table was built from.
+    [[nodiscard]] double rate() const noexcept { return m_rate; }
+
+   private:
+    std::size_t m_spotPoints;
+    std::size_t m_timePoints;
+    double m_maturity;
+    double m_rate;
+    double m_logSpotMin;
+    double m_invLogSpotStep;
+    double m_invTimeStep;
+    double m_lastIndex;          ///< spotPoints - 1 as double (upper clamp of lookup()).
+    std::vector<double> m_table;  ///< [time][log-spot], rows and columns padded by one.
+};
+
+}  // namespace mcopt
@@ -1,18 +1,38 @@
 #include "MCEngine.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <future>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <random>
+#include <sstream>
 #include <stdexcept>
-#include <thread>
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
 
+#include "Constants.hpp"
+#include "NormalGenerator.hpp"
+#include "RandomStream.hpp"
+#include "Serialization.hpp"
+
 namespace mcopt {
 
 MonteCarloEngine::MonteCarloEngine(std::shared_ptr<Payoff> payoff, double S0, double T, double r,
                                    double sigma, uint64_t seed)
-    : m_payoff(std::move(payoff)), m_S0(S0), m_T(T), m_r(r), m_sigma(sigma), m_seed(seed) {
+    : m_payoff(std::move(payoff)),
+      m_S0(S0),
+      m_T(T),
+      m_r(r),
+      m_sigma(sigma),
+      m_seed(seed),
+      m_rateCurve(r),
+      m_volCurve(sigma) {
     if (!m_payoff) {
         throw std::invalid_argument("Payoff pointer cannot be null.");
     }
@@ -20,112 +40,610 @@ MonteCarloEngine::MonteCarloEngine(std::shared_ptr<Payoff> payoff, double S0, do
         throw std::invalid_argument("Invalid market parameters (S0, T, sigma must be >= 0).");
     }
     // Инициализация: берем максимум ядер или 1, если не определилось
-    unsigned int hwThreads = std::thread::hardware_concurrency();
-    m_numThreads = (hwThreads > 0) ? hwThreads : 1;
+    m_numThreads = resolveThreadCount(0);
 }
 
 void MonteCarloEngine::setNumThreads(unsigned int threads) {
-    if (threads == 0) {
-        // Если передали 0, сбрасываем на дефолт (hardware)
-        unsigned int hw = std::thread::hardware_concurrency();
-        m_numThreads = (hw > 0) ? hw : 1;
-    } else {
-        m_numThreads = threads;
+    m_numThreads = resolveThreadCount(threads);  // 0 — сброс на число ядер
+}
+
+double MonteCarloEngine::discountFactor() const noexcept {
+    return std::exp(-m_rateCurve.integral(0.0, m_T));
+}
+
+void MonteCarloEngine::setResultCache(std::shared_ptr<ResultCache> cache) {
+    m_cache = std::move(cache);
+}
+
+void MonteCarloEngine::setVariateBank(std::shared_ptr<const VariateBank> bank) {
+    m_variateBank = std::move(bank);
+}
+
+void MonteCarloEngine::setPrecision(Precision precision) noexcept { m_precision = precision; }
+
+Precision MonteCarloEngine::precision() const noexcept { return m_precision; }
+
+void MonteCarloEngine::setNormalMethod(NormalMethod method) noexcept { m_normalMethod = method; }
+
+NormalMethod MonteCarloEngine::normalMethod() const noexcept { return m_normalMethod; }
+
+// ==========================================
+// Временная структура параметров и дивиденды
+// ==========================================
+
+void MonteCarloEngine::setRateCurve(PiecewiseConstantCurve curve) {
+    m_rateCurve = std::move(curve);
+    // Плоская кривая эквивалентна константе: ее видят и методы без поддержки кривых
+    if (m_rateCurve.isFlat()) m_r = m_rateCurve.values().front();
+}
+
+void MonteCarloEngine::setVolCurve(PiecewiseConstantCurve curve) {
+    for (double v : curve.values()) {
+        if (v < 0.0) throw std::invalid_argument("Volatility curve values must be >= 0.");
     }
+    m_volCurve = std::move(curve);
+    if (m_volCurve.isFlat()) m_sigma = m_volCurve.values().front();
 }
 
-// Чанк симуляции
-double MonteCarloEngine::runSimulationChunk(double spot, unsigned long long numPaths,
-                                            unsigned long long chunkIndex) const {
-    std::mt19937_64 rng(m_seed + chunkIndex);
+void MonteCarloEngine::setDividends(std::vector<Dividend> dividends) {
+    for (const Dividend& d : dividends) {
+        if (!(d.time > 0.0)) {
+            throw std::invalid_argument("Dividend ex-date must be positive.");
+        }
+        bool valid = (d.type == DividendType::Cash) ? d.amount >= 0.0
+                                                    : (d.amount >= 0.0 && d.amount < 1.0);
+        if (!valid) {
+            throw std::invalid_argument(
+                "Dividend amount must be >= 0 (cash) or in [0, 1) (proportional).");
+        }
+    }
+    std::stable_sort(dividends.begin(), dividends.end(),
+                     [](const Dividend& a, const Dividend& b) { return a.time < b.time; });
+    m_dividends = std::move(dividends);
+}
 
-    std::normal_distribution<double> dist(0.0, 1.0);
+bool MonteCarloEngine::hasTermStructure() const noexcept {
+    return !m_rateCurve.isFlat() || !m_volCurve.isFlat() || !m_dividends.empty();
+}
 
-    double sumPayoff = 0.0;
-    double drift = (m_r - 0.5 * m_sigma * m_sigma) * m_T;
-    double diffusion = m_sigma * std::sqrt(m_T);
+void MonteCarloEngine::requireFlatParameters(const char* method) const {
+    if (hasTermStructure()) {
+        throw std::logic_error(std::string(method) +
+                               " supports only constant rate and volatility without dividends.");
+    }
+}
 
-    for (unsigned long long i = 0; i < numPaths / 2; ++i) {
-        double Z = dist(rng);
+MonteCarloEngine::StepTables MonteCarloEngine::buildStepTables(unsigned int numSteps) const {
+    const unsigned int steps = (numSteps == 0) ? 1 : numSteps;
+    const double dt = m_T / static_cast<double>(steps);
 
-        double ST_plus = spot * std::exp(drift + diffusion * Z);
-        double payoff_plus = (*m_payoff)(ST_plus);
+    StepTables tables;
+    tables.drift.resize(steps);
+    tables.diffusion.resize(steps);
+    tables.escrow.assign(steps, 0.0);
 
-        double ST_minus = spot * std::exp(drift + diffusion * (-Z));
-        double payoff_minus = (*m_payoff)(ST_minus);
+    for (unsigned int j = 0; j < steps; ++j) {
+        const double t0 = dt * static_cast<double>(j);
+        const double t1 = (j + 1 == steps) ? m_T : dt * static_cast<double>(j + 1);
+        double r = 0.0;
+        double sigma = 0.0;
+        if (m_rateCurve.constantOn(t0, t1, r) && m_volCurve.constantOn(t0, t1, sigma)) {
+            // Шаг внутри одного интервала: те же формулы, что и при постоянных параметрах
+            tables.drift[j] = (r - 0.5 * sigma * sigma) * dt;
+            tables.diffusion[j] = sigma * std::sqrt(dt);
+        } else {
+            const double variance = m_volCurve.squareIntegral(t0, t1);
+            tables.drift[j] = m_rateCurve.integral(t0, t1) - 0.5 * variance;
+            tables.diffusion[j] = std::sqrt(variance);
+        }
+    }
 
-        sumPayoff += (payoff_plus + payoff_minus);
+    for (const Dividend& d : m_dividends) {
+        if (d.time > m_T) continue;
+        if (d.type == DividendType::Proportional) {
+            // Шаг j покрывает (t_j, t_{j+1}]
+            auto j = static_cast<unsigned int>(std::ceil(d.time / dt)) - 1;
+            tables.drift[std::min(j, steps - 1)] += std::log1p(-d.amount);
+            continue;
+        }
+        tables.escrow0 += d.amount * std::exp(-m_rateCurve.integral(0.0, d.time));
+        for (unsigned int j = 0; j < steps; ++j) {
+            const double t = (j + 1 == steps) ? m_T : dt * static_cast<double>(j + 1);
+            if (d.time > t) {
+                tables.escrow[j] += d.amount * std::exp(-m_rateCurve.integral(t, d.time));
+            }
+        }
+    }
+    return tables;
+}
+
+// Размер пачки путей в ядрах: генерация, эволюция и выплаты идут отдельными циклами
+// по массивам фиксированной длины, что позволяет компилятору векторизовать арифметику
+static constexpr unsigned long long KERNEL_BATCH = 256;
+
+namespace {
+
+// Нормали блока: из банка на месте (double) или живым генератором в буфер пачки.
+// Банк хранит тот же поток, поэтому результат от источника не зависит
+template <typename Real>
+class BlockNormals {
+   public:
+    BlockNormals(const VariateBank* bank, uint64_t seed, NormalMethod method,
+                 unsigned long long block, std::size_t count)
+        : m_bank(bank ? bank->stream(seed, method, block, count) : nullptr), m_normals(method) {
+        if (!m_bank) m_rng = makeStreamRng(seed, STREAM_PATH_BLOCKS, block);
+    }
+
+    // Следующие n <= KERNEL_BATCH нормалей потока
+    const Real* next(std::size_t n) {
+        if (!m_bank) {
+            m_normals.fill(m_rng, m_buffer.data(), n);
+            return m_buffer.data();
+        }
+        const double* z = m_bank;
+        m_bank += n;
+        if constexpr (std::is_same_v<Real, double>) {
+            return z;
+        } else {
+            for (std::size_t i = 0; i < n; ++i) m_buffer[i] = static_cast<Real>(z[i]);
+            return m_buffer.data();
+        }
+    }
+
+   private:
+    const double* m_bank;
+    std::mt19937_64 m_rng;
+    NormalGenerator m_normals;
+    std::array<Real, KERNEL_BATCH> m_buffer{};
+};
+
+// Вызывает fn с функцией выплаты. Встроенные колл и пут подставляются лямбдой (max без
+// ветвлений, побитово как PayoffCall / PayoffPut), и циклы ядра векторизуются; тип
+// сравнивается точно, поэтому наследник со своей выплатой идет через Payoff::operator()
+template <typename Fn>
+void withPayoff(const Payoff& payoff, Fn&& fn) {
+    const double K = payoff.strike();
+    if (typeid(payoff) == typeid(PayoffCall)) {
+        fn([K](double s) noexcept { return std::max(s - K, 0.0); });
+    } else if (typeid(payoff) == typeid(PayoffPut)) {
+        fn([K](double s) noexcept { return std::max(K - s, 0.0); });
+    } else {
+        fn([&payoff](double s) noexcept { return payoff(s); });
+    }
+}
+
+}  // namespace
+
+// Блок симуляции
+template <typename Real>
+PathStatistics MonteCarloEngine::runSimulationChunk(double spot, unsigned long long block,
+                                                    unsigned long long numPaths,
+                                                    const StepTables& tables) const {
+    // Одна нормаль на пару и одна на непарный путь
+    BlockNormals<Real> normals(m_variateBank.get(), m_seed, m_normalMethod, block,
+                               numPaths / 2 + numPaths % 2);
+
+    // Один шаг до погашения: интегральные дрейф и дисперсия из таблицы
+    const Real s0 = static_cast<Real>(spot);
+    const auto drift = static_cast<Real>(tables.drift[0]);
+    const auto diffusion = static_cast<Real>(tables.diffusion[0]);
+
+    // S_T = s0 * g, как в runLadderChunk(): лестница спотов совпадает с отдельным расчетом
+    std::array<Real, KERNEL_BATCH> growthPlus{};
+    std::array<Real, KERNEL_BATCH> growthMinus{};
+    BlockAccumulator acc;
+
+    // Antithetic Variates: пара (Z, -Z) дает одну выборку
+    const unsigned long long pairs = numPaths / 2;
+    for (unsigned long long start = 0; start < pairs; start += KERNEL_BATCH) {
+        unsigned long long n = std::min(KERNEL_BATCH, pairs - start);
+        const Real* Z = normals.next(n);
+        for (unsigned long long i = 0; i < n; ++i) {
+            growthPlus[i] = std::exp(drift + diffusion * Z[i]);
+            growthMinus[i] = std::exp(drift + diffusion * (-Z[i]));
+        }
+        // Суммы пачки всегда в double
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        withPayoff(*m_payoff, [&](auto payoff) {
+            for (unsigned long long i = 0; i < n; ++i) {
+                double y = 0.5 * (payoff(s0 * growthPlus[i]) + payoff(s0 * growthMinus[i]));
+                batchSum += y;
+                batchSumSq += y * y;
+            }
+        });
+        acc.addBatch(batchSum, batchSumSq, n);
     }
 
     if (numPaths % 2 != 0) {
-        double Z = dist(rng);
-        double ST = spot * std::exp(drift + diffusion * Z);
-        sumPayoff += (*m_payoff)(ST);
+        const Real z = normals.next(1)[0];
+        double y = (*m_payoff)(s0 * std::exp(drift + diffusion * z));
+        acc.addBatch(y, y * y, 1);
     }
 
-    return sumPayoff;
+    return acc.result();
 }
 
-double MonteCarloEngine::runAsianChunk(unsigned long long numPaths, unsigned int numSteps,
-                                       unsigned long long chunkIndex) const {
-    std::mt19937_64 rng(m_seed + chunkIndex);
-    std::normal_distribution<double> dist(0.0, 1.0);
+template <typename Real>
+PathStatistics MonteCarloEngine::runAsianChunk(unsigned long long block,
+                                               unsigned long long numPaths, unsigned int numSteps,
+                                               const StepTables& tables) const {
+    BlockNormals<Real> normals(m_variateBank.get(), m_seed, m_normalMethod, block,
+                               numPaths * numSteps);
 
-    double sumPayoff = 0.0;
-    double dt = m_T / static_cast<double>(numSteps);
+    // Дрейф, диффузия и эскроу дивидендов каждого шага — в Real, один раз на блок
+    std::vector<Real> driftPart(numSteps);
+    std::vector<Real> volPart(numSteps);
+    std::vector<Real> escrow(numSteps);
+    for (unsigned int j = 0; j < numSteps; ++j) {
+        driftPart[j] = static_cast<Real>(tables.drift[j]);
+        volPart[j] = static_cast<Real>(tables.diffusion[j]);
+        escrow[j] = static_cast<Real>(tables.escrow[j]);
+    }
+    const auto s0 = static_cast<Real>(m_S0 - tables.escrow0);
 
-    // Предварительные вычисления для оптимизации (дрейф и диффузия на шаге dt)
-    double driftPart = (m_r - 0.5 * m_sigma * m_sigma) * dt;
-    double volPart = m_sigma * std::sqrt(dt);
+    // Пачка путей идет по времени синхронно: на каждом шаге один векторизуемый цикл по путям
+    std::array<Real, KERNEL_BATCH> currentSpot{};
+    std::array<Real, KERNEL_BATCH> sumSpots{};  // Для среднего арифметического
+    BlockAccumulator acc;
 
-    for (unsigned long long i = 0; i < numPaths; ++i) {
-        double currentSpot = m_S0;
-        double sumSpots = 0.0;  // Для среднего арифметического
+    for (unsigned long long start = 0; start < numPaths; start += KERNEL_BATCH) {
+        unsigned long long n = std::min(KERNEL_BATCH, numPaths - start);
+        currentSpot.fill(s0);
+        sumSpots.fill(Real(0));
 
         // Шагаем по времени: t_0 -> t_1 -> ... -> t_N
         // Азиатский опцион обычно не включает S0 в среднее, или включает - зависит от
         // контракта. Будем считать среднее по точкам мониторинга t_1...t_N
         for (unsigned int j = 0; j < numSteps; ++j) {
-            double Z = dist(rng);
-            currentSpot *= std::exp(driftPart + volPart * Z);
-            sumSpots += currentSpot;
+            const Real* Z = normals.next(n);
+            const Real drift = driftPart[j];
+            const Real vol = volPart[j];
+            const Real dividends = escrow[j];
+            for (unsigned long long i = 0; i < n; ++i) {
+                currentSpot[i] *= std::exp(drift + vol * Z[i]);
+                sumSpots[i] += currentSpot[i] + dividends;
+            }
         }
 
-        double averageSpot = sumSpots / static_cast<double>(numSteps);
-        sumPayoff += (*m_payoff)(averageSpot);
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            double averageSpot = static_cast<double>(sumSpots[i]) / static_cast<double>(numSteps);
+            double y = (*m_payoff)(averageSpot);
+            batchSum += y;
+            batchSumSq += y * y;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
     }
 
-    return sumPayoff;  // Возвращаем сумму, дисконтировать будем в вызывающем методе
+    return acc.result();  // Недисконтированные суммы, дисконтировать будем в вызывающем методе
 }
 
-// Обертка для запуска потоков
-double MonteCarloEngine::runSimulationForSpot(double spot,
-                                              unsigned long long numSimulations) const {
-    unsigned int numThreads = m_numThreads;
-    if (numThreads == 0) numThreads = 1;
-    // unsigned int numThreads = std::thread::hardware_concurrency();
-    // if (numThreads == 0) numThreads = 2;
+MonteCarloEngine::AdjointSums MonteCarloEngine::runAsianAdjointChunk(
+    unsigned long long block, unsigned long long numPaths, unsigned int numSteps) const {
+    BlockNormals<double> normals(m_variateBank.get(), m_seed, m_normalMethod, block,
+                                 numPaths * numSteps);
 
-    unsigned long long pathsPerThread = numSimulations / numThreads;
-    unsigned long long leftoverPaths = numSimulations % numThreads;
+    // Прямой проход повторяет runAsianChunk<double> операция в операцию
+    const double dt = m_T / static_cast<double>(numSteps);
+    const double driftPart = (m_r - 0.5 * m_sigma * m_sigma) * dt;
+    const double volPart = m_sigma * std::sqrt(dt);
+    const double sqrtDt = std::sqrt(dt);
 
-    std::vector<std::future<double>> futures;
-    futures.reserve(numThreads);
+    std::array<double, KERNEL_BATCH> currentSpot{};
+    std::array<double, KERNEL_BATCH> sumSpots{};
+    std::array<double, KERNEL_BATCH> spotBar{};     // dY/dS_j текущего шага обратного прохода
+    std::array<double, KERNEL_BATCH> averageBar{};  // dY/dA / N
+
+    // Лента одной пачки: S_{j+1} и dlog(S_{j+1})/dsigma_j, раскладка [шаг][путь]
+    std::vector<double> spotTape(KERNEL_BATCH * numSteps);
+    std::vector<double> vegaTape(KERNEL_BATCH * numSteps);
+
+    AdjointSums sums;
+    sums.bucketVega.assign(numSteps, 0.0);
+    BlockAccumulator acc;
 
-    for (unsigned int i = 0; i < numThreads; ++i) {
-        unsigned long long paths = pathsPerThread + (i == 0 ? leftoverPaths : 0);
-        // Передаем 'i' как chunkIndex.
-        // i изменяется от 0 до numThreads-1, обеспечивая уникальность seed для каждого потока.
-        futures.push_back(std::async(std::launch::async, &MonteCarloEngine::runSimulationChunk,
-                                     this, spot, paths, i));
+    for (unsigned long long start = 0; start < numPaths; start += KERNEL_BATCH) {
+        unsigned long long n = std::min(KERNEL_BATCH, numPaths - start);
+        currentSpot.fill(m_S0);
+        sumSpots.fill(0.0);
+
+        // Прямой проход
+        for (unsigned int j = 0; j < numSteps; ++j) {
+            const double* Z = normals.next(n);
+            double* spots = spotTape.data() + j * KERNEL_BATCH;
+            double* vegas = vegaTape.data() + j * KERNEL_BATCH;
+            for (unsigned long long i = 0; i < n; ++i) {
+                currentSpot[i] *= std::exp(driftPart + volPart * Z[i]);
+                sumSpots[i] += currentSpot[i];
+                spots[i] = currentSpot[i];
+                vegas[i] = sqrtDt * Z[i] - m_sigma * dt;
+            }
+        }
+
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            double averageSpot = sumSpots[i] / static_cast<double>(numSteps);
+            double y = (*m_payoff)(averageSpot);
+            batchSum += y;
+            batchSumSq += y * y;
+            averageBar[i] = m_payoff->derivative(averageSpot) / static_cast<double>(numSteps);
+            spotBar[i] = 0.0;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
+
+        // Обратный проход: S_{j+1} = S_j * exp(...), каждая S_{j+1} входит в среднее
+        double batchRho = 0.0;
+        for (unsigned int j = numSteps; j-- > 0;) {
+            const double* spots = spotTape.data() + j * KERNEL_BATCH;
+            const double* vegas = vegaTape.data() + j * KERNEL_BATCH;
+            double bucket = 0.0;
+            double stepRho = 0.0;
+            for (unsigned long long i = 0; i < n; ++i) {
+                double bar = spotBar[i] + averageBar[i];  // dY/dS_{j+1}
+                double local = bar * spots[i];            // dY/dlog(S_{j+1})
+                bucket += local * vegas[i];
+                stepRho += local;
+                double previous = (j > 0) ? spotTape[(j - 1) * KERNEL_BATCH + i] : m_S0;
+                spotBar[i] = local / previous;  // dY/dS_j
+            }
+            sums.bucketVega[j] += bucket;
+            batchRho += stepRho * dt;
+        }
+        sums.rho += batchRho;
+        for (unsigned long long i = 0; i < n; ++i) {
+            sums.delta += spotBar[i];
+        }
     }
 
-    double totalSum = 0.0;
+    sums.payoff = acc.result();
+    return sums;
+}
+
+template <typename Real>
+std::vector<PathStatistics> MonteCarloEngine::runLadderChunk(const std::vector<double>& spots,
+                                                             unsigned long long block,
+                                                             unsigned long long numPaths,
+                                                             const StepTables& tables) const {
+    BlockNormals<Real> normals(m_variateBank.get(), m_seed, m_normalMethod, block,
+                               numPaths / 2 + numPaths % 2);
+
+    const auto drift = static_cast<Real>(tables.drift[0]);
+    const auto diffusion = static_cast<Real>(tables.diffusion[0]);
+
+    // Множители роста считаются пачками и переиспользуются для всех спотов
+    std::array<Real, KERNEL_BATCH> growthPlus{};
+    std::array<Real, KERNEL_BATCH> growthMinus{};
+    const std::size_t numSpots = spots.size();
+    std::vector<Real> spot(spots.begin(), spots.end());
+    std::vector<double> batchSum(numSpots);
+    std::vector<double> batchSumSq(numSpots);
+    std::vector<BlockAccumulator> acc(numSpots);
+
+    const unsigned long long pairs = numPaths / 2;
+    for (unsigned long long start = 0; start < pairs; start += KERNEL_BATCH) {
+        unsigned long long n = std::min(KERNEL_BATCH, pairs - start);
+        const Real* Z = normals.next(n);
+        for (unsigned long long i = 0; i < n; ++i) {
+            growthPlus[i] = std::exp(drift + diffusion * Z[i]);
+            growthMinus[i] = std::exp(drift + diffusion * (-Z[i]));
+        }
+        // Внешний цикл по парам, внутренний по спотам: внутренний векторизуется, а суммы
+        // каждого спота накапливаются в том же порядке путей, что и в runSimulationChunk()
+        std::fill(batchSum.begin(), batchSum.end(), 0.0);
+        std::fill(batchSumSq.begin(), batchSumSq.end(), 0.0);
+        withPayoff(*m_payoff, [&](auto payoff) {
+            for (unsigned long long i = 0; i < n; ++i) {
+                const Real up = growthPlus[i];
+                const Real down = growthMinus[i];
+                for (std::size_t k = 0; k < numSpots; ++k) {
+                    double y = 0.5 * (payoff(spot[k] * up) + payoff(spot[k] * down));
+                    batchSum[k] += y;
+                    batchSumSq[k] += y * y;
+                }
+            }
+        });
+        for (std::size_t k = 0; k < numSpots; ++k) {
+            acc[k].addBatch(batchSum[k], batchSumSq[k], n);
+        }
+    }
+
+    if (numPaths % 2 != 0) {
+        Real growth = std::exp(drift + diffusion * normals.next(1)[0]);
+        for (std::size_t k = 0; k < numSpots; ++k) {
+            double y = (*m_payoff)(spot[k] * growth);
+            acc[k].addBatch(y, y * y, 1);
+        }
+    }
+
+    std::vector<PathStatistics> stats;
+    stats.reserve(spots.size());
+    for (const auto& a : acc) stats.push_back(a.result());
+    return stats;
+}
+
+// Распределение блоков по потокам: каждый поток получает непрерывный диапазон
+void MonteCarloEngine::parallelForBlocks(
+    unsigned long long numBlocks,
+    const std::function<void(unsigned long long, unsigned long long)>& fn) const {
+    mcopt::parallelForBlocks(numBlocks, m_numThreads, fn);
+}
+
+std::vector<PathStatistics> MonteCarloEngine::runBlocks(double spot, unsigned int numSteps,
+                                                        unsigned long long firstBlock,
+                                                        unsigned long long lastBlock,
+                                                        unsigned long long numSimulations) const {
+    unsigned long long numBlocks = (lastBlock > firstBlock) ? lastBlock - firstBlock : 0;
+    std::vector<PathStatistics> blocks(numBlocks);
+    const StepTables tables = buildStepTables(numSteps);
+
+    // Каждый поток пишет в свою часть вектора
+    parallelForBlocks(numBlocks, [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runBlock(spot, numSteps, firstBlock + b, numSimulations, tables);
+        }
+    });
+
+    return blocks;
+}
+
+PathStatistics MonteCarloEngine::runBlock(double spot, unsigned int numSteps,
+                                          unsigned long long block,
+                                          unsigned long long numSimulations,
+                                          const StepTables& tables) const {
+    unsigned long long paths = pathsInBlock(block, numSimulations);
+    const double escrowedSpot = spot - tables.escrow0;
+    if (escrowedSpot <= 0.0 && spot > 0.0) {
+        throw std::invalid_argument("Present value of cash dividends exceeds the spot.");
+    }
+    if (m_precision == Precision::Single) {
+        return (numSteps == 0) ? runSimulationChunk<float>(escrowedSpot, block, paths, tables)
+                               : runAsianChunk<float>(block, paths, numSteps, tables);
+    }
+    return (numSteps == 0) ? runSimulationChunk<double>(escrowedSpot, block, paths, tables)
+                           : runAsianChunk<double>(block, paths, numSteps, tables);
+}
+
+PricingResult MonteCarloEngine::runCancellable(double spot, unsigned int numSteps,
+                                               unsigned long long numSimulations,
+                                               PricingState& state) const {
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<PathStatistics> blocks(numBlocks);
+    std::vector<char> finished(numBlocks, 0);
+    std::atomic<unsigned long long> nextBlock{0};
+    const StepTables tables = buildStepTables(numSteps);
+
+    // Динамическая раздача блоков: отмена проверяется перед каждым блоком
+    auto worker = [&]() {
+        while (!state.cancelled()) {
+            unsigned long long b = nextBlock++;
+            if (b >= numBlocks) break;
+            blocks[b] = runBlock(spot, numSteps, b, numSimulations, tables);
+            finished[b] = 1;
+            state.addBlock(blocks[b], pathsInBlock(b, numSimulations));
+        }
+    };
+
+    unsigned long long numThreads = std::min<unsigned long long>(
+        (m_numThreads > 0) ? m_numThreads : 1, std::max(numBlocks, 1ULL));
+    std::vector<std::future<void>> futures;
+    futures.reserve(numThreads);
+    for (unsigned long long i = 0; i < numThreads; ++i) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
     for (auto& f : futures) {
-        totalSum += f.get();
+        f.get();
+    }
+
+    // Свертка завершенных блоков в порядке номеров (как в синхронном расчете)
+    PathStatistics total;
+    unsigned long long paths = 0;
+    for (unsigned long long b = 0; b < numBlocks; ++b) {
+        if (finished[b] == 0) continue;
+        total.merge(blocks[b]);
+        paths += pathsInBlock(b, numSimulations);
+    }
+    return {state.discount() * total.mean(), state.discount() * total.standardError(), paths};
+}
+
+std::vector<PathStatistics> MonteCarloEngine::simulateBlocks(unsigned long long firstBlock,
+                                                             unsigned long long lastBlock,
+                                                             unsigned long long numSimulations,
+                                                             unsigned int numSteps) const {
+    return runBlocks(m_S0, numSteps, firstBlock, lastBlock, numSimulations);
+}
+
+bool MonteCarloEngine::cacheable() const noexcept {
+    // Ключ описывает выплату именем и страйком: наследник с той же парой дал бы чужую цену
+    return m_cache && isBuiltinPayoff(*m_payoff);
+}
+
+std::string MonteCarloEngine::cacheKey(double spot, unsigned int numSteps) const {
+    std::ostringstream key;
+    key << m_payoff->name() << ';' << doubleToBits(m_payoff->strike()) << ';'
+        << doubleToBits(spot) << ';' << doubleToBits(m_T) << ';' << doubleToBits(m_r) << ';'
+        << doubleToBits(m_sigma) << ';' << m_seed << ';' << numSteps << ';'
+        << static_cast<int>(m_precision) << ';' << static_cast<int>(m_normalMethod);
+    // Кривые и дивиденды входят в ключ только если заданы
+    if (hasTermStructure()) {
+        for (const auto* curve : {&m_rateCurve, &m_volCurve}) {
+            key << ";c";
+            for (double t : curve->knots()) key << ',' << doubleToBits(t);
+            key << '|';
+            for (double v : curve->values()) key << ',' << doubleToBits(v);
+        }
+        for (const Dividend& d : m_dividends) {
+            key << ";d" << static_cast<int>(d.type) << ',' << doubleToBits(d.time) << ','
+                << doubleToBits(d.amount);
+        }
+    }
+    return key.str();
+}
+
+PathStatistics MonteCarloEngine::simulateStatistics(double spot, unsigned int numSteps,
+                                                    unsigned long long numSimulations) const {
+    unsigned long long numBlocks = blockCount(numSimulations);
+    if (!cacheable()) {
+        return reduceBlocks(runBlocks(spot, numSteps, 0, numBlocks, numSimulations));
+    }
+
+    const std::string key = cacheKey(spot, numSteps);
+    std::optional<CacheEntry> cached = m_cache->find(key);
+    if (cached && cached->paths() == numSimulations) {
+        return cached->total();  // Идентичный запрос
+    }
+
+    const unsigned long long first = resumeBlock(cached, numSimulations);
+    return storeBlocks(key, cached, runBlocks(spot, numSteps, first, numBlocks, numSimulations),
+                       first, numSimulations);
+}
+
+unsigned long long MonteCarloEngine::resumeBlock(const std::optional<CacheEntry>& cached,
+                                                 unsigned long long numSimulations) noexcept {
+    // Продолжаем свертку с последнего полного блока; если в кэше больше путей,
+    // чем запрошено, префикс не подходит — считаем заново
+    const unsigned long long fullBlocks = numSimulations / PATHS_PER_BLOCK;
+    return (cached && cached->completeBlocks <= fullBlocks) ? cached->completeBlocks : 0;
+}
+
+PathStatistics MonteCarloEngine::storeBlocks(const std::string& key,
+                                             const std::optional<CacheEntry>& cached,
+                                             const std::vector<PathStatistics>& blocks,
+                                             unsigned long long firstBlock,
+                                             unsigned long long numSimulations) const {
+    const unsigned long long fullBlocks = numSimulations / PATHS_PER_BLOCK;
+    const unsigned long long tailPaths = numSimulations % PATHS_PER_BLOCK;
+
+    bool extend = cached && cached->completeBlocks <= fullBlocks;
+    CacheEntry entry{};
+    if (extend) {
+        entry.prefix = cached->prefix;
+        entry.completeBlocks = cached->completeBlocks;
     }
 
-    return std::exp(-m_r * m_T) * (totalSum / static_cast<double>(numSimulations));
+    // Блоки до firstBlock уже свернуты в префикс записи
+    for (unsigned long long b = entry.completeBlocks; b < fullBlocks; ++b) {
+        entry.prefix.merge(blocks[b - firstBlock]);
+    }
+    if (tailPaths > 0) {
+        entry.tail = blocks.back();
+        entry.tailPaths = tailPaths;
+    }
+    entry.completeBlocks = fullBlocks;
+
+    // Запись с большим числом путей, чем запрошено, не трогаем
+    if (extend || !cached) {
+        m_cache->store(key, entry);
+    }
+    return entry.total();
+}
+
+// Обертка для запуска потоков
+double MonteCarloEngine::runSimulationForSpot(double spot,
+                                              unsigned long long numSimulations) const {
+    return discountFactor() * simulateStatistics(spot, 0, numSimulations).mean();
 }
 
 double MonteCarloEngine::calculatePrice(unsigned long long numSimulations) const {
@@ -134,24 +652,868 @@ double MonteCarloEngine::calculatePrice(unsigned long long numSimulations) const
 
 double MonteCarloEngine::calculateAsianPrice(unsigned long long numSimulations,
                                              unsigned int numSteps) const {
-    unsigned int numThreads = m_numThreads;  // Используем то число потоков, которое настроено
-    unsigned long long pathsPerThread = numSimulations / numThreads;
-    unsigned long long leftover = numSimulations % numThreads;
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
+    }
+    // Дисконтирование
+    return discountFactor() * simulateStatistics(m_S0, numSteps, numSimulations).mean();
+}
 
-    std::vector<std::future<double>> futures;
-    for (unsigned int i = 0; i < numThreads; ++i) {
-        unsigned long long paths = pathsPerThread + (i == 0 ? leftover : 0);
-        futures.push_back(std::async(std::launch::async, &MonteCarloEngine::runAsianChunk, this,
-                                     paths, numSteps, i));
+AsianSensitivities MonteCarloEngine::calculateAsianSensitivities(
+    unsigned long long numSimulations, unsigned int numSteps) const {
+    requireFlatParameters("Adjoint sensitivities");
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
     }
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<AdjointSums> blocks(numBlocks);
+    parallelForBlocks(numBlocks, [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runAsianAdjointChunk(b, pathsInBlock(b, numSimulations), numSteps);
+        }
+    });
 
-    double totalSum = 0.0;
-    for (auto& f : futures) {
-        totalSum += f.get();
+    // Свертка в порядке блоков, как в reduceBlocks()
+    PathStatistics payoff;
+    double delta = 0.0;
+    double rho = 0.0;
+    std::vector<double> bucketVega(numSteps, 0.0);
+    for (const auto& b : blocks) {
+        payoff.merge(b.payoff);
+        delta += b.delta;
+        rho += b.rho;
+        for (unsigned int j = 0; j < numSteps; ++j) bucketVega[j] += b.bucketVega[j];
     }
 
-    // Дисконтирование
-    return std::exp(-m_r * m_T) * (totalSum / static_cast<double>(numSimulations));
+    const double discount = discountFactor();
+    const double scale = (payoff.count > 0) ? discount / static_cast<double>(payoff.count) : 0.0;
+    AsianSensitivities result{};
+    result.price = discount * payoff.mean();
+    result.standardError = discount * payoff.standardError();
+    result.delta = scale * delta;
+    result.rho = scale * rho - m_T * result.price;  // Дисконт-фактор тоже зависит от r
+    result.bucketVega = std::move(bucketVega);
+    for (double& v : result.bucketVega) v *= scale;
+    result.vega = std::accumulate(result.bucketVega.begin(), result.bucketVega.end(), 0.0);
+    return result;
+}
+
+// ==========================================
+// Importance sampling
+// ==========================================
+
+std::vector<double> MonteCarloEngine::importanceDrift(unsigned int numSteps) const {
+    requireFlatParameters("Importance sampling");
+    // Европейский опцион — тот же путь из одного шага, выплата от S_T (= среднему по одной точке)
+    const unsigned int steps = (numSteps == 0) ? 1 : numSteps;
+    const double dt = m_T / static_cast<double>(steps);
+    const double driftPart = (m_r - 0.5 * m_sigma * m_sigma) * dt;
+    const double volPart = m_sigma * std::sqrt(dt);
+    std::vector<double> spots(steps);
+
+    // Аргумент выплаты и его градиент по z: dA/dz_j = volPart * sum_{k>j} S_k / N
+    auto evaluate = [&](const std::vector<double>& z, std::vector<double>* gradient) {
+        double spot = m_S0;
+        double sum = 0.0;
+        for (unsigned int j = 0; j < steps; ++j) {
+            spot *= std::exp(driftPart + volPart * z[j]);
+            spots[j] = spot;
+            sum += spot;
+        }
+        if (gradient != nullptr) {
+            double tail = 0.0;
+            for (unsigned int j = steps; j-- > 0;) {
+                tail += spots[j];
+                (*gradient)[j] = volPart * tail / static_cast<double>(steps);
+            }
+        }
+        return sum / static_cast<double>(steps);
+    };
+    auto objective = [&](const std::vector<double>& z) {
+        double f = (*m_payoff)(evaluate(z, nullptr));
+        if (!(f > 0.0)) return -std::numeric_limits<double>::infinity();
+        double norm2 = std::inner_product(z.begin(), z.end(), z.begin(), 0.0);
+        return std::log(f) - 0.5 * norm2;
+    };
+
+    // 1. Поиск по прямой: ранние приращения двигают весь путь, направление ~ (N - j)
+    std::vector<double> direction(steps);
+    for (unsigned int j = 0; j < steps; ++j) direction[j] = static_cast<double>(steps - j);
+    double dirNorm = std::sqrt(std::inner_product(direction.begin(), direction.end(),
+                                                  direction.begin(), 0.0));
+    for (double& d : direction) d /= dirNorm;
+
+    // Диапазон |c| <= bound удваивается, пока не найдется положительная выплата: у глубоко
+    // OTM страйков (S0 = 10, K = 100 — около 16 SD) она лежит дальше 10 стандартных отклонений.
+    // За 40 SD вероятность области исполнения ниже наименьшего double — цену не оценить
+    constexpr double MAX_SHIFT = 40.0;
+    std::vector<double> z(steps, 0.0);
+    std::vector<double> candidate(steps);
+    double best = -std::numeric_limits<double>::infinity();
+    for (double bound = 10.0; best == -std::numeric_limits<double>::infinity() &&
+                              bound <= MAX_SHIFT;
+         bound *= 2.0) {
+        for (int k = -1000; k <= 1000; ++k) {
+            double c = 0.001 * bound * k;
+            for (unsigned int j = 0; j < steps; ++j) candidate[j] = c * direction[j];
+            double value = objective(candidate);
+            if (value > best) {
+                best = value;
+                z = candidate;
+            }
+        }
+    }
+    if (best == -std::numeric_limits<double>::infinity()) {
+        throw std::runtime_error(
+            "Importance sampling: payoff is zero within 40 standard deviations, no shift found.");
+    }
+
+    // 2. Подъем по градиенту grad = f'(A) / f(A) * dA/dz - z с дроблением шага
+    //    (в точке максимума это условие неподвижной точки z = grad log f)
+    std::vector<double> gradient(steps);
+    double step = 1.0;
+    for (int iter = 0; iter < 500 && step > 1e-12; ++iter) {
+        double A = evaluate(z, &gradient);
+        double scale = m_payoff->derivative(A) / (*m_payoff)(A);
+        double norm = 0.0;
+        for (unsigned int j = 0; j < steps; ++j) {
+            gradient[j] = scale * gradient[j] - z[j];
+            norm = std::max(norm, std::abs(gradient[j]));
+        }
+        if (norm < 1e-10) break;
+
+        for (; step > 1e-12; step *= 0.5) {
+            for (unsigned int j = 0; j < steps; ++j) candidate[j] = z[j] + step * gradient[j];
+            double value = objective(candidate);
+            if (value > best) {
+                best = value;
+                z = candidate;
+                step = std::min(2.0 * step, 1.0);
+                break;
+            }
+        }
+    }
+    return z;
+}
+
+MonteCarloEngine::ImportanceSums MonteCarloEngine::runImportanceChunk(
+    unsigned long long block, unsigned long long numPaths, unsigned int numSteps,
+    const std::vector<double>& drift) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, STREAM_IMPORTANCE, block);
+    const NormalGenerator normals(m_normalMethod);
+
+    const unsigned int steps = static_cast<unsigned int>(drift.size());
+    const double dt = m_T / static_cast<double>(steps);
+    const double driftPart = (m_r - 0.5 * m_sigma * m_sigma) * dt;
+    const double volPart = m_sigma * std::sqrt(dt);
+    const double halfNorm2 =
+        0.5 * std::inner_product(drift.begin(), drift.end(), drift.begin(), 0.0);
+
+    std::array<double, KERNEL_BATCH> currentSpot{};
+    std::array<double, KERNEL_BATCH> sumSpots{};
+    std::array<double, KERNEL_BATCH> logWeight{};
+    std::array<double, KERNEL_BATCH> eps{};
+    BlockAccumulator acc;
+    CompensatedSum secondMoment;
+
+    for (unsigned long long start = 0; start < numPaths; start += KERNEL_BATCH) {
+        unsigned long long n = std::min(KERNEL_BATCH, numPaths - start);
+        currentSpot.fill(m_S0);
+        sumSpots.fill(0.0);
+        logWeight.fill(-halfNorm2);
+
+        // Z = mu + eps, отношение правдоподобия L = exp(-mu.eps - |mu|^2 / 2)
+        for (unsigned int j = 0; j < steps; ++j) {
+            normals.fill(rng, eps.data(), n);
+            const double mu = drift[j];
+            for (unsigned long long i = 0; i < n; ++i) {
+                currentSpot[i] *= std::exp(driftPart + volPart * (mu + eps[i]));
+                sumSpots[i] += currentSpot[i];
+                logWeight[i] -= mu * eps[i];
+            }
+        }
+
+        double batchSum = 0.0;
+        double batchSumSq = 0.0;
+        double batchSecond = 0.0;
+        for (unsigned long long i = 0; i < n; ++i) {
+            double argument = (numSteps == 0) ? currentSpot[i]
+                                              : sumSpots[i] / static_cast<double>(steps);
+            double f = (*m_payoff)(argument);
+            double weight = std::exp(logWeight[i]);
+            double y = f * weight;
+            batchSum += y;
+            batchSumSq += y * y;
+            batchSecond += f * y;
+        }
+        acc.addBatch(batchSum, batchSumSq, n);
+        secondMoment.add(batchSecond);
+    }
+
+    return {acc.result(), secondMoment.value()};
+}
+
+ImportanceSamplingResult MonteCarloEngine::runImportanceSampling(
+    unsigned long long numSimulations, unsigned int numSteps) const {
+    std::vector<double> drift = importanceDrift(numSteps);
+
+    const unsigned long long numBlocks = blockCount(numSimulations);
+    std::vector<ImportanceSums> blocks(numBlocks);
+    parallelForBlocks(numBlocks, [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long b = begin; b < end; ++b) {
+            blocks[b] = runImportanceChunk(b, pathsInBlock(b, numSimulations), numSteps, drift);
+        }
+    });
+
+    PathStatistics weighted;
+    double second = 0.0;
+    for (const auto& b : blocks) {
+        weighted.merge(b.weighted);
+        second += b.plainSecondMoment;
+    }
+
+    // Дисперсия обычного MC по тем же выборкам: E[f^2] - E[f]^2
+    double n = static_cast<double>(weighted.count);
+    double mean = weighted.mean();
+    double plainVariance = (n > 0.0) ? std::max(second / n - mean * mean, 0.0) : 0.0;
+    double isVariance = weighted.variance();
+
+    const double discount = discountFactor();
+    ImportanceSamplingResult result{};
+    result.price = discount * mean;
+    result.standardError = discount * weighted.standardError();
+    result.paths = numSimulations;
+    result.drift = std::move(drift);
+    result.varianceReduction = (isVariance > 0.0) ? plainVariance / isVariance : 1.0;
+    return result;
+}
+
+ImportanceSamplingResult MonteCarloEngine::calculatePriceIS(
+    unsigned long long numSimulations) const {
+    return runImportanceSampling(numSimulations, 0);
+}
+
+ImportanceSamplingResult MonteCarloEngine::calculateAsianPriceIS(
+    unsigned long long numSimulations, unsigned int numSteps) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
+    }
+    return runImportanceSampling(numSimulations, numSteps);
+}
+
+// ==========================================
+// Stratified и Latin hypercube sampling
+// ==========================================
+
+double MonteCarloEngine::pairPayoff(const std::vector<double>& z, unsigned int numSteps,
+                                    const BrownianBridge* bridge,
+                                    std::vector<double>& path) const {
+    if (numSteps == 0) {
+        const double drift = (m_r - 0.5 * m_sigma * m_sigma) * m_T;
+        const double diffusion = m_sigma * std::sqrt(m_T);
+        double payoff_plus = (*m_payoff)(m_S0 * std::exp(drift + diffusion * z[0]));
+        double payoff_minus = (*m_payoff)(m_S0 * std::exp(drift - diffusion * z[0]));
+        return 0.5 * (payoff_plus + payoff_minus);
+    }
+
+    // Путь строится мостом; антитетичный путь — это -W
+    const double dt = m_T / static_cast<double>(numSteps);
+    const double driftPart = (m_r - 0.5 * m_sigma * m_sigma) * dt;
+    const double volPart = m_sigma * std::sqrt(dt);
+    bridge->buildPath(z.data(), path.data());
+    double sumPlus = 0.0;
+    double sumMinus = 0.0;
+    for (unsigned int j = 0; j < numSteps; ++j) {
+        double drift = driftPart * static_cast<double>(j + 1);
+        sumPlus += m_S0 * std::exp(drift + volPart * path[j]);
+        sumMinus += m_S0 * std::exp(drift - volPart * path[j]);
+    }
+    double payoff_plus = (*m_payoff)(sumPlus / static_cast<double>(numSteps));
+    double payoff_minus = (*m_payoff)(sumMinus / static_cast<double>(numSteps));
+    return 0.5 * (payoff_plus + payoff_minus);
+}
+
+PathStatistics MonteCarloEngine::runStratum(unsigned int stratum, unsigned int numStrata,
+                                            unsigned long long numPairs, unsigned int numSteps,
+                                            uint32_t domain) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, domain, stratum);
+    const NormalGenerator normals(m_normalMethod);
+    const unsigned int dims = (numSteps == 0) ? 1 : numSteps;
+    std::optional<BrownianBridge> bridge;
+    if (numSteps > 0) bridge.emplace(numSteps);
+
+    std::vector<double> z(dims);
+    std::vector<double> path(dims);
+    PathStatistics stats;
+    for (unsigned long long i = 0; i < numPairs; ++i) {
+        double u = (static_cast<double>(stratum) + NormalGenerator::uniform(rng())) /
+                   static_cast<double>(numStrata);
+        z[0] = NormalGenerator::inverseCdf(u);
+        if (dims > 1) normals.fill(rng, z.data() + 1, dims - 1);
+        stats.add(pairPayoff(z, numSteps, bridge ? &*bridge : nullptr, path));
+    }
+    return stats;
+}
+
+PricingResult MonteCarloEngine::calculateStratifiedPrice(unsigned long long numSimulations,
+                                                         unsigned int numSteps,
+                                                         unsigned int numStrata,
+                                                         Allocation allocation) const {
+    requireFlatParameters("Stratified sampling");
+    if (numStrata == 0) {
+        throw std::invalid_argument("Stratified sampling needs at least one stratum.");
+    }
+    const unsigned long long pairs = numSimulations / 2;
+    if (pairs < 2ULL * numStrata) {
+        throw std::invalid_argument("Stratified sampling needs at least two pairs per stratum.");
+    }
+
+    // Пропорциональное распределение пар по стратам (остаток — первым стратам)
+    auto proportional = [numStrata](unsigned long long total) {
+        std::vector<unsigned long long> n(numStrata, total / numStrata);
+        for (unsigned long long k = 0; k < total % numStrata; ++k) ++n[k];
+        return n;
+    };
+    auto runAll = [&](const std::vector<unsigned long long>& n, uint32_t domain) {
+        std::vector<PathStatistics> strata(numStrata);
+        parallelForBlocks(numStrata, [&](unsigned long long begin, unsigned long long end) {
+            for (unsigned long long k = begin; k < end; ++k) {
+                auto stratum = static_cast<unsigned int>(k);
+                strata[k] = runStratum(stratum, numStrata, n[k], numSteps, domain);
+            }
+        });
+        return strata;
+    };
+
+    std::vector<unsigned long long> allocationPairs = proportional(pairs);
+    if (allocation == Allocation::Neyman) {
+        // Пилот: 10% пар (не меньше двух на страту) только для оценки s_k
+        unsigned long long pilotPairs = std::max<unsigned long long>(pairs / 10, 2ULL * numStrata);
+        unsigned long long mainPairs = pairs - pilotPairs;
+        std::vector<PathStatistics> pilot =
+            runAll(proportional(pilotPairs), STREAM_STRATIFIED_PILOT);
+
+        std::vector<double> sd(numStrata);
+        double total = 0.0;
+        for (unsigned int k = 0; k < numStrata; ++k) {
+            sd[k] = std::sqrt(pilot[k].variance());
+            total += sd[k];
+        }
+        if (total > 0.0 && mainPairs >= 2ULL * numStrata) {
+            // n_k = 2 + доля остатка пропорционально s_k; округление вниз, остаток — по порядку
+            unsigned long long spare = mainPairs - 2ULL * numStrata;
+            unsigned long long assigned = 0;
+            for (unsigned int k = 0; k < numStrata; ++k) {
+                auto share = static_cast<unsigned long long>(static_cast<double>(spare) * sd[k] /
+                                                             total);
+                allocationPairs[k] = 2 + share;
+                assigned += share;
+            }
+            for (unsigned long long k = 0; assigned < spare; k = (k + 1) % numStrata) {
+                ++allocationPairs[k];
+                ++assigned;
+            }
+        } else {
+            allocationPairs = proportional(std::max(mainPairs, 2ULL * numStrata));
+        }
+    }
+
+    std::vector<PathStatistics> strata = runAll(allocationPairs, STREAM_STRATIFIED);
+
+    // Страты равновероятны: p_k = 1 / K
+    const double p = 1.0 / static_cast<double>(numStrata);
+    double mean = 0.0;
+    double variance = 0.0;
+    unsigned long long used = 0;
+    for (const auto& s : strata) {
+        mean += p * s.mean();
+        variance += p * p * s.variance() / static_cast<double>(s.count);
+        used += s.count;
+    }
+    const double discount = discountFactor();
+    return {discount * mean, discount * std::sqrt(variance), 2 * used};
+}
+
+double MonteCarloEngine::runLatinReplicate(unsigned int replicate, unsigned long long numPairs,
+                                           unsigned int numSteps, unsigned int dimensions) const {
+    std::mt19937_64 rng = makeStreamRng(m_seed, STREAM_LATIN_HYPERCUBE, replicate);
+    const NormalGenerator normals(m_normalMethod);
+    const unsigned int dims = (numSteps == 0) ? 1 : numSteps;
+    const unsigned int stratified = std::min(dimensions, dims);
+    std::optional<BrownianBridge> bridge;
+    if (numSteps > 0) bridge.emplace(numSteps);
+
+    // Латинский гиперкуб: по каждому измерению своя случайная перестановка ячеек
+    // (Фишер–Йейтс на собственных равномерных величинах — std::shuffle зависит от реализации)
+    std::vector<std::vector<double>> cells(stratified, std::vector<double>(numPairs));
+    for (auto& column : cells) {
+        std::vector<unsigned long long> perm(numPairs);
+        std::iota(perm.begin(), perm.end(), 0ULL);
+        for (unsigned long long i = numPairs; i-- > 1;) {
+            auto j = static_cast<unsigned long long>(NormalGenerator::uniform(rng()) *
+                                                     static_cast<double>(i + 1));
+            std::swap(perm[i], perm[std::min(j, i)]);
+        }
+        for (unsigned long long i = 0; i < numPairs; ++i) {
+            double u = (static_cast<double>(perm[i]) + NormalGenerator::uniform(rng())) /
+                       static_cast<double>(numPairs);
+            column[i] = NormalGenerator::inverseCdf(u);
+        }
+    }
+
+    std::vector<double> z(dims);
+    std::vector<double> path(dims);
+    CompensatedSum sum;
+    for (unsigned long long i = 0; i < numPairs; ++i) {
+        for (unsigned int d = 0; d < stratified; ++d) z[d] = cells[d][i];
+        if (dims > stratified) normals.fill(rng, z.data() + stratified, dims - stratified);
+        sum.add(pairPayoff(z, numSteps, bridge ? &*bridge : nullptr, path));
+    }
+    return sum.value() / static_cast<double>(numPairs);
+}
+
+PricingResult MonteCarloEngine::calculateLatinHypercubePrice(unsigned long long numSimulations,
+                                                             unsigned int numSteps,
+                                                             unsigned int dimensions,
+                                                             unsigned int replicates) const {
+    requireFlatParameters("Latin hypercube sampling");
+    if (dimensions == 0) {
+        throw std::invalid_argument("Latin hypercube needs at least one stratified dimension.");
+    }
+    if (replicates < 2) {
+        throw std::invalid_argument("Latin hypercube needs at least two replicates.");
+    }
+    const unsigned long long pairsPerReplicate = numSimulations / 2 / replicates;
+    if (pairsPerReplicate == 0) {
+        throw std::invalid_argument("Too few paths for the number of Latin hypercube replicates.");
+    }
+
+    std::vector<double> means(replicates);
+    parallelForBlocks(replicates, [&](unsigned long long begin, unsigned long long end) {
+        for (unsigned long long r = begin; r < end; ++r) {
+            means[r] = runLatinReplicate(static_cast<unsigned int>(r), pairsPerReplicate,
+                                         numSteps, dimensions);
+        }
+    });
+
+    // Средние реплик независимы и одинаково распределены
+    PathStatistics stats;
+    for (double m : means) stats.add(m);
+    const double discount = discountFactor();
+    return {discount * stats.mean(), discount * stats.standardError(),
+            2 * pairsPerReplicate * replicates};
+}
+
+PricingHandle MonteCarloEngine::calculatePriceAsync(unsigned long long numSimulations) const {
+    auto state = std::make_shared<PricingState>(numSimulations, discountFactor());
+    // Копия движка живет вместе с задачей
+    std::future<PricingResult> result =
+        std::async(std::launch::async, [engine = *this, state, numSimulations]() {
+            return engine.runCancellable(engine.m_S0, 0, numSimulations, *state);
+        });
+    return {state, std::move(result)};
+}
+
+PricingHandle MonteCarloEngine::calculateAsianPriceAsync(unsigned long long numSimulations,
+                                                         unsigned int numSteps) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
+    }
+    auto state = std::make_shared<PricingState>(numSimulations, discountFactor());
+    std::future<PricingResult> result =
+        std::async(std::launch::async, [engine = *this, state, numSimulations, numSteps]() {
+            return engine.runCancellable(engine.m_S0, numSteps, numSimulations, *state);
+        });
+    return {state, std::move(result)};
+}
+
+namespace {
+
+// Дискретное MLMC: последний уровень ceil(log2 N) берет все N дат мониторинга
+unsigned int discreteFinestLevel(unsigned int numSteps) {
+    unsigned int level = 0;
+    while ((1ULL << level) < numSteps) ++level;
+    return level;
+}
+
+// Число дат мониторинга на мелкой сетке уровня: каждая 2^(L - l)-я дата, считая от t_N
+unsigned long long discreteLevelDates(unsigned int level, unsigned int numSteps) {
+    const unsigned long long stride = 1ULL << (discreteFinestLevel(numSteps) - level);
+    return (numSteps + stride - 1) / stride;
+}
+
+}  // namespace
+
+std::pair<double, double> MonteCarloEngine::runMLMCLevelChunk(unsigned int level,
+                                                             unsigned int numSteps,
+                                                             unsigned long long numPaths,
+                                                             unsigned long long streamId) const {
+    const uint32_t domain = (numSteps == 0) ? STREAM_MLMC : STREAM_MLMC_DISCRETE;
+    std::mt19937_64 rng = makeStreamRng(m_seed, domain + level, streamId);
+    const NormalGenerator normals(m_normalMethod);
+
+    const double discount = discountFactor();
+    const double mu = m_r - 0.5 * m_sigma * m_sigma;
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+
+    if (numSteps > 0) {
+        // Дискретное среднее по t_1..t_N. Мелкая сетка уровня — даты t_N, t_{N-s}, ... с шагом
+        // s = 2^(L - l), каждая с весом s (самая ранняя покрывает остаток от t_0); грубая —
+        // каждая вторая из них с весом 2s на тех же значениях пути. Путь GBM на датах точный,
+        // на уровне L (s = 1) среднее совпадает с calculateAsianPrice(numSteps)
+        const unsigned long long stride = 1ULL << (discreteFinestLevel(numSteps) - level);
+        const unsigned long long dates = discreteLevelDates(level, numSteps);
+        const unsigned long long first = numSteps - (dates - 1) * stride;  // Индекс ранней даты
+        const unsigned long long coarseFirst = (dates - 1) & ~1ULL;  // Ранняя грубая дата, j
+        const double h = m_T / static_cast<double>(numSteps);
+        const double firstDrift = mu * static_cast<double>(first) * h;
+        const double firstVol = m_sigma * std::sqrt(static_cast<double>(first) * h);
+        const double strideDrift = mu * static_cast<double>(stride) * h;
+        const double strideVol = m_sigma * std::sqrt(static_cast<double>(stride) * h);
+        const double invDates = 1.0 / static_cast<double>(numSteps);
+
+        for (unsigned long long i = 0; i < numPaths; ++i) {
+            double spot = m_S0;
+            double fineSum = 0.0;
+            double coarseSum = 0.0;
+            // Дата j (индекс N - j s) идет от ранней к t_N
+            for (unsigned long long j = dates; j-- > 0;) {
+                const bool earliest = (j == dates - 1);
+                spot *= std::exp(earliest ? firstDrift + firstVol * normals(rng)
+                                          : strideDrift + strideVol * normals(rng));
+                fineSum += static_cast<double>(earliest ? first : stride) * spot;
+                if (j % 2 == 0) {
+                    double weight = (j == coarseFirst)
+                                        ? static_cast<double>(numSteps - j * stride)
+                                        : static_cast<double>(2 * stride);
+                    coarseSum += weight * spot;
+                }
+            }
+            double delta = discount * (*m_payoff)(fineSum * invDates);
+            if (level > 0) delta -= discount * (*m_payoff)(coarseSum * invDates);
+            sum += delta;
+            sumSq += delta * delta;
+        }
+        return {sum, sumSq};
+    }
+
+    // Уровень 0: один шаг, поправки нет
+    const unsigned int fineSteps = 1U << level;
+    const double hf = m_T / static_cast<double>(fineSteps);
+    const double fineDrift = mu * hf;
+    const double fineVol = m_sigma * std::sqrt(hf);
+    const double coarseDrift = 2.0 * fineDrift;
+    const double coarseVol = m_sigma * std::sqrt(2.0 * hf);
+
+    for (unsigned long long i = 0; i < numPaths; ++i) {
+        double fineSpot = m_S0;
+        double fineSum = 0.5 * m_S0;  // Трапеции: S_0 и S_N входят с весом 1/2
+
+        double delta = 0.0;
+        if (level == 0) {
+            fineSpot *= std::exp(fineDrift + fineVol * normals(rng));
+            fineSum += 0.5 * fineSpot;
+            delta = discount * (*m_payoff)(fineSum);
+        } else {
+            double coarseSpot = m_S0;
+            double coarseSum = 0.5 * m_S0;
+
+            // Грубый шаг = два мелких на том же броуновском приращении
+            for (unsigned int j = 0; j < fineSteps / 2; ++j) {
+                double Z1 = normals(rng);
+                double Z2 = normals(rng);
+
+                fineSpot *= std::exp(fineDrift + fineVol * Z1);
+                fineSum += fineSpot;
+                fineSpot *= std::exp(fineDrift + fineVol * Z2);
+                fineSum += fineSpot;
+
+                coarseSpot *= std::exp(coarseDrift + coarseVol * (Z1 + Z2) / math::SQRT2);
+                coarseSum += coarseSpot;
+            }
+            fineSum -= 0.5 * fineSpot;
+            coarseSum -= 0.5 * coarseSpot;
+
+            double fineAverage = fineSum / static_cast<double>(fineSteps);
+            double coarseAverage = coarseSum / static_cast<double>(fineSteps / 2);
+            delta = discount * ((*m_payoff)(fineAverage) - (*m_payoff)(coarseAverage));
+        }
+
+        sum += delta;
+        sumSq += delta * delta;
+    }
+
+    return {sum, sumSq};
+}
+
+MLMCResult MonteCarloEngine::calculateAsianPriceMLMC(double targetRmse, unsigned int maxLevel,
+                                                     unsigned long long pilotPaths) const {
+    if (maxLevel < 2) {
+        throw std::invalid_argument("MLMC needs maxLevel >= 2.");
+    }
+    return runMLMC(targetRmse, std::min(maxLevel, 30U), pilotPaths, 0);
+}
+
+MLMCResult MonteCarloEngine::calculateDiscreteAsianPriceMLMC(double targetRmse,
+                                                             unsigned int numSteps,
+                                                             unsigned long long pilotPaths) const {
+    if (numSteps == 0) {
+        throw std::invalid_argument("Asian option needs at least one time step.");
+    }
+    return runMLMC(targetRmse, discreteFinestLevel(numSteps), pilotPaths, numSteps);
+}
+
+MLMCResult MonteCarloEngine::runMLMC(double targetRmse, unsigned int maxLevel,
+                                     unsigned long long pilotPaths, unsigned int numSteps) const {
+    requireFlatParameters("Multilevel Monte Carlo");
+    if (!(targetRmse > 0.0)) {
+        throw std::invalid_argument("MLMC target RMSE must be positive.");
+    }
+    if (pilotPaths < 2) {
+        throw std::invalid_argument("MLMC needs at least 2 pilot paths.");
+    }
+
+    const unsigned int numThreads = (m_numThreads > 0) ? m_numThreads : 1;
+
+    std::vector<unsigned long long> paths;
+    std::vector<double> sums;
+    std::vector<double> sumsSq;
+    std::vector<double> seconds;
+    std::vector<double> cost;
+    std::vector<unsigned long long> batches;
+
+    auto addLevel = [&]() {
+        auto l = static_cast<unsigned int>(paths.size());
+        paths.push_back(0);
+        sums.push_back(0.0);
+        sumsSq.push_back(0.0);
+        seconds.push_back(0.0);
+        batches.push_back(0);
+        if (numSteps > 0) {
+            // Грубая сетка использует значения мелкой: стоимость — число дат уровня
+            cost.push_back(static_cast<double>(discreteLevelDates(l, numSteps)));
+            return;
+        }
+        double fineSteps = std::ldexp(1.0, static_cast<int>(l));
+        cost.push_back(l == 0 ? fineSteps : 1.5 * fineSteps);
+    };
+
+    // Запуск dN путей уровня l на всех потоках движка
+    auto runLevel = [&](unsigned int l, unsigned long long dN) {
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long perThread = dN / numThreads;
+        unsigned long long leftover = dN % numThreads;
+
+        std::vector<std::future<std::pair<double, double>>> futures;
+        futures.reserve(numThreads);
+        for (unsigned int i = 0; i < numThreads; ++i) {
+            unsigned long long n = perThread + (i == 0 ? leftover : 0);
+            unsigned long long streamId = batches[l] * numThreads + i;
+            futures.push_back(std::async(std::launch::async, &MonteCarloEngine::runMLMCLevelChunk,
+                                         this, l, numSteps, n, streamId));
+        }
+        for (auto& f : futures) {
+            auto [s1, s2] = f.get();
+            sums[l] += s1;
+            sumsSq[l] += s2;
+        }
+        paths[l] += dN;
+        ++batches[l];
+        seconds[l] +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Порядки сходимости: слабый alpha (смещение) и beta (дисперсия поправок).
+    // Оцениваются регрессией по уровням l >= 1, снизу ограничены 0.5.
+    auto regressionSlope = [](const std::vector<double>& y) {
+        // Наклон log2(y_l) по l для l = 1..L
+        double n = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+        for (std::size_t l = 1; l < y.size(); ++l) {
+            if (y[l] <= 0.0) continue;
+            double x = static_cast<double>(l);
+            double v = std::log2(y[l]);
+            n += 1.0;
+            sx += x;
+            sy += v;
+            sxx += x * x;
+            sxy += x * v;
+        }
+        if (n < 2.0) return 0.5;
+        return std::max(0.5, -(n * sxy - sx * sy) / (n * sxx - sx * sx));
+    };
+
+    const double theta = 0.5;  // Доля квадрата ошибки, отводимая под дисперсию
+    const double eps2 = targetRmse * targetRmse;
+
+    unsigned int L = std::min(2U, maxLevel);
+    std::vector<unsigned long long> dN(L + 1, pilotPaths);
+    for (unsigned int l = 0; l <= L; ++l) addLevel();
+
+    std::vector<double> means;
+    std::vector<double> vars;
+    bool converged = true;
+
+    while (true) {
+        for (unsigned int l = 0; l <= L; ++l) {
+            if (dN[l] > 0) runLevel(l, dN[l]);
+        }
+
+        means.assign(L + 1, 0.0);
+        vars.assign(L + 1, 0.0);
+        for (unsigned int l = 0; l <= L; ++l) {
+            double n = static_cast<double>(paths[l]);
+            means[l] = std::abs(sums[l] / n);
+            vars[l] = std::max(0.0, sumsSq[l] / n - means[l] * means[l]);
+        }
+
+        std::vector<double> absMeans = means;
+        std::vector<double> variances = vars;
+        double alpha = regressionSlope(absMeans);
+        double beta = regressionSlope(variances);
+
+        // Защита от случайно малых оценок на старших уровнях
+        for (unsigned int l = 2; l <= L; ++l) {
+            absMeans[l] = std::max(absMeans[l], 0.5 * absMeans[l - 1] / std::exp2(alpha));
+            variances[l] = std::max(variances[l], 0.5 * variances[l - 1] / std::exp2(beta));
+        }
+
+        // Оптимальное число путей на уровень
+        auto optimalPaths = [&]() {
+            double sumSqrtVC = 0.0;
+            for (unsigned int l = 0; l <= L; ++l) sumSqrtVC += std::sqrt(variances[l] * cost[l]);
+            bool more = false;
+            for (unsigned int l = 0; l <= L; ++l) {
+                double target = std::ceil(std::sqrt(variances[l] / cost[l]) * sumSqrtVC /
+                                          ((1.0 - theta) * eps2));
+                auto Nl = static_cast<unsigned long long>(std::max(target, 2.0));
+                dN[l] = (Nl > paths[l]) ? Nl - paths[l] : 0;
+                if (static_cast<double>(dN[l]) > 0.01 * static_cast<double>(paths[l])) more = true;
+            }
+            return more;
+        };
+
+        if (optimalPaths()) continue;
+
+        // Дискретное среднее: последний уровень — сам контракт, смещения нет
+        if (numSteps > 0 && L == maxLevel) break;
+
+        // Проверка смещения по последним уровням
+        double remainder = 0.0;
+        for (unsigned int k = 0; k < 3 && k < L; ++k) {
+            remainder = std::max(remainder, absMeans[L - k] / std::exp2(alpha * k));
+        }
+        remainder /= (std::exp2(alpha) - 1.0);
+
+        if (remainder <= std::sqrt(theta) * targetRmse) break;
+        if (L == maxLevel) {
+            converged = false;
+            break;
+        }
+
+        // Добавляем уровень с экстраполированной дисперсией
+        ++L;
+        addLevel();
+        variances.push_back(variances[L - 1] / std::exp2(beta));
+        dN.push_back(0);
+        optimalPaths();
+    }
+
+    MLMCResult result{0.0, 0.0, 0.0, converged, {}};
+    double errorVariance = 0.0;
+    for (unsigned int l = 0; l <= L; ++l) {
+        double n = static_cast<double>(paths[l]);
+        double mean = sums[l] / n;
+        double var = std::max(0.0, sumsSq[l] / n - mean * mean);
+        result.price += mean;
+        errorVariance += var / n;
+        result.totalCost += n * cost[l];
+        auto steps = (numSteps > 0) ? static_cast<unsigned int>(discreteLevelDates(l, numSteps))
+                                    : 1U << l;
+        result.levels.push_back({steps, paths[l], mean, var, cost[l], seconds[l]});
+    }
+    result.standardError = std::sqrt(errorVariance);
+    return result;
+}
+
+std::vector<PricingResult> MonteCarloEngine::calculateSpotLadder(
+    const std::vector<double>& spots, unsigned long long numSimulations) const {
+    unsigned long long numBlocks = blockCount(numSimulations);
+    const StepTables tables = buildStepTables(0);
+
+    // Денежные дивиденды: эволюционирует спот за вычетом их приведенной стоимости
+    std::vector<double> escrowedSpots(spots);
+    for (double& spot : escrowedSpots) {
+        if (spot > 0.0 && spot <= tables.escrow0) {
+            throw std::invalid_argument("Present value of cash dividends exceeds the spot.");
+        }
+        spot -= tables.escrow0;
+    }
+
+    // С кэшем у каждого спота своя запись (ключ как у calculatePrice()): полностью
+    // посчитанные споты не симулируются, остальные продолжают свои префиксы
+    std::vector<PathStatistics> totals(spots.size());
+    std::vector<std::string> keys(spots.size());
+    std::vector<std::optional<CacheEntry>> cached(spots.size());
+    std::vector<std::size_t> pending;
+    std::vector<double> pendingSpots;
+    unsigned long long first = numBlocks;
+    const bool useCache = cacheable();
+    for (std::size_t k = 0; k < spots.size(); ++k) {
+        if (useCache) {
+            keys[k] = cacheKey(spots[k], 0);
+            cached[k] = m_cache->find(keys[k]);
+            if (cached[k] && cached[k]->paths() == numSimulations) {
+                totals[k] = cached[k]->total();
+                continue;
+            }
+        }
+        pending.push_back(k);
+        pendingSpots.push_back(escrowedSpots[k]);
+        first = std::min(first, resumeBlock(cached[k], numSimulations));
+    }
+
+    if (!pending.empty()) {
+        std::vector<std::vector<PathStatistics>> blocks(numBlocks - first);
+        parallelForBlocks(numBlocks - first, [&](unsigned long long begin, unsigned long long end) {
+            for (unsigned long long i = begin; i < end; ++i) {
+                unsigned long long b = first + i;
+                unsigned long long paths = pathsInBlock(b, numSimulations);
+                blocks[i] = (m_precision == Precision::Single)
+                                ? runLadderChunk<float>(pendingSpots, b, paths, tables)
+                                : runLadderChunk<double>(pendingSpots, b, paths, tables);
+            }
+        });
+
+        // Свертка по блокам в каноническом порядке — отдельно для каждого спота
+        std::vector<PathStatistics> column(blocks.size());
+        for (std::size_t j = 0; j < pending.size(); ++j) {
+            for (std::size_t i = 0; i < blocks.size(); ++i) column[i] = blocks[i][j];
+            const std::size_t k = pending[j];
+            totals[k] = useCache ? storeBlocks(keys[k], cached[k], column, first, numSimulations)
+                                : reduceBlocks(column);
+        }
+    }
+
+    const double discount = discountFactor();
+    std::vector<PricingResult> results;
+    results.reserve(spots.size());
+    for (const PathStatistics& total : totals) {
+        results.push_back(
+            {discount * total.mean(), discount * total.standardError(), numSimulations});
+    }
+    return results;
+}
+
+std::vector<PricingResult> MonteCarloEngine::calculateSpotShocks(
+    const std::vector<double>& relativeShocks, unsigned long long numSimulations) const {
+    std::vector<double> spots;
+    spots.reserve(relativeShocks.size());
+    for (double shock : relativeShocks) {
+        spots.push_back(m_S0 * (1.0 + shock));
+    }
+    return calculateSpotLadder(spots, numSimulations);
 }
 
 // Метод конечных разностей для Греков
@@ -159,14 +1521,11 @@ Greeks MonteCarloEngine::calculateGreeks(unsigned long long numSimulations) {
     // Шаг сдвига (1% от цены или меньше)
     double h = std::max(m_S0 * 1e-4, 1e-4);
 
-    // 1. Базовая цена
-    double price = runSimulationForSpot(m_S0, numSimulations);
-
-    // 2. Цена вверх (S + h)
-    double priceUp = runSimulationForSpot(m_S0 + h, numSimulations);
-
-    // 3. Цена вниз (S - h)
-    double priceDown = runSimulationForSpot(m_S0 - h, numSimulations);
+    // Базовая цена, цена вверх (S + h) и вниз (S - h) за один проход по путям
+    auto ladder = calculateSpotLadder({m_S0, m_S0 + h, m_S0 - h}, numSimulations);
+    double price = ladder[0].price;
+    double priceUp = ladder[1].price;
+    double priceDown = ladder[2].price;
 
     Greeks g;
     g.price = price;
@@ -180,4 +1539,4 @@ Greeks MonteCarloEngine::calculateGreeks(unsigned long long numSimulations) {
     return g;
 }
 
-}  // namespace mcopt
\ No newline at end of file
+}  // namespace mcopt
@@ -1,11 +1,23 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "Analytical.hpp"
+#include "AsyncPricing.hpp"
+#include "BrownianBridge.hpp"
+#include "NormalGenerator.hpp"
 #include "Payoff.hpp"
+#include "ResultCache.hpp"
+#include "Statistics.hpp"
+#include "TermStructure.hpp"
+#include "VariateBank.hpp"
 
 /**
  * @namespace mcopt
@@ -26,6 +38,87 @@
 
 namespace mcopt {
 
+/**
+ * @struct MLMCLevel
+ * @brief Statistics of a single level of the Multilevel Monte Carlo estimator.
+ *
+ * Level \f$ l \f$ estimates \f$ E[P_l - P_{l-1}] \f$ (or \f$ E[P_0] \f$ for \f$ l = 0 \f$),
+ * where \f$ P_l \f$ is the discounted payoff on a grid of \f$ 2^l \f$ time steps.
+ */
+struct MLMCLevel {
+    unsigned int steps;        ///< Number of fine time steps on this level (\f$ 2^l \f$).
+    unsigned long long paths;  ///< Number of coupled fine/coarse path pairs simulated.
+    double mean;               ///< Sample mean of the level correction \f$ P_l - P_{l-1} \f$.
+    double variance;           ///< Sample variance of the level correction.
+    double costPerPath;        ///< Cost of one sample in time steps (fine + coarse).
+    double seconds;            ///< Wall-clock time spent on this level.
+};
+
+/**
+ * @struct MLMCResult
+ * @brief Result of a Multilevel Monte Carlo run with the per-level cost breakdown.
+ */
+struct MLMCResult {
+    double price;                   ///< Telescoping sum of the level means.
+    double standardError;           ///< Statistical error \f$ \sqrt{\sum_l V_l / N_l} \f$.
+    double totalCost;               ///< Total cost in time steps \f$ \sum_l N_l C_l \f$.
+    bool converged;                 ///< False if the bias test failed at the maximum level.
+    std::vector<MLMCLevel> levels;  ///< Per-level breakdown (level 0 first).
+};
+
+/**
+ * @struct ImportanceSamplingResult
+ * @brief Result of an importance-sampling run.
+ */
+struct ImportanceSamplingResult {
+    double price;               ///< Discounted likelihood-ratio weighted estimate.
+    double standardError;       ///< Standard error of the estimate.
+    unsigned long long paths;   ///< Number of paths.
+    std::vector<double> drift;  ///< Mean shift of the normal driver of each step.
+    /**
+     * Estimated variance of plain Monte Carlo (one path per sample) divided by the variance of
+     * the importance-sampling estimator, at the same number of paths. Values above ~2 mean the
+     * mode pays off.
+     */
+    double varianceReduction;
+};
+
+/**
+ * @enum Allocation
+ * @brief How paths are distributed over the strata of stratified sampling.
+ */
+enum class Allocation {
+    Proportional,  ///< Equal-probability strata get equal numbers of paths.
+    Neyman         ///< Paths proportional to the stratum standard deviation (from a pilot).
+};
+
+/**
+ * @struct AsianSensitivities
+ * @brief Price and pathwise sensitivities of an Asian option from one adjoint run.
+ *
+ * The volatility of time step \f$ j \f$ (interval \f$ (t_j, t_{j+1}] \f$) is treated as a
+ * separate input \f$ \sigma_j \f$; `vega` is the sum of the bucket vegas (parallel shift).
+ */
+struct AsianSensitivities {
+    double price;                    ///< Discounted price (identical to calculateAsianPrice()).
+    double standardError;            ///< Standard error of the price.
+    double delta;                    ///< \f$ \partial V / \partial S_0 \f$.
+    double vega;                     ///< \f$ \partial V / \partial \sigma \f$.
+    double rho;                      ///< \f$ \partial V / \partial r \f$.
+    std::vector<double> bucketVega;  ///< \f$ \partial V / \partial \sigma_j \f$, one per step.
+};
+
+/**
+ * @enum Precision
+ * @brief Floating-point type used for normal variates and path evolution.
+ *
+ * Reductions (batch sums, block sums, compensated accumulation) are always in double.
+ */
+enum class Precision {
+    Double,  ///< 64-bit paths (default).
+    Single   ///< 32-bit paths: twice the SIMD lane width, double accumulation.
+};
+
 /**
  * @class MonteCarloEngine
  * @brief High-performance parallel Monte Carlo pricing engine.
@@ -40,8 +133,12 @@ namespace mcopt {
  * - **Parallel Execution:** Uses `std::async` and `std::future` for multi-threaded simulation.
  * - **Variance Reduction:** Implements **Antithetic Variates** technique (using \f$ Z \f$ and \f$
  * -Z \f$).
- * - **Reproducibility:** Supports deterministic execution via seeded RNG (`std::mt19937_64`).
+ * - **Reproducibility:** Paths are grouped into blocks of `PATHS_PER_BLOCK` paths, each with its
+ *   own RNG stream addressed by (seed, block index). Block statistics are reduced in block
+ *   order, so results do not depend on the number of threads or processes.
  * - **Greeks Calculation:** Computes Delta and Gamma using Finite Difference Methods.
+ * - **Result Cache:** Optional ResultCache; repeated requests are answered from the cache and
+ *   larger path counts only simulate the missing blocks.
  */
 class MonteCarloEngine {
    public:
@@ -73,18 +170,222 @@ class MonteCarloEngine {
      * - **Gamma:** Second order difference \f$ \Gamma \approx \frac{V(S+h) - 2V(S) + V(S-h)}{h^2}
      * \f$
      *
+     * The three spot points are evaluated in one pass over shared path factors
+     * (see calculateSpotLadder()), so the cost is that of a single simulation.
+     *
      * @param numSimulations Total number of paths to simulate for each spot point.
      * @return A Greeks structure containing price, delta, and gamma.
      */
     [[nodiscard]] Greeks calculateGreeks(unsigned long long numSimulations);
+    /**
+     * @brief Prices the European payoff for a whole ladder of spot levels in one pass.
+     *
+     * Under GBM the terminal spot is linear in \f$ S_0 \f$:
+     * \f$ S_T = S_0 \, g \f$ with \f$ g = \exp((r - \sigma^2/2)T + \sigma\sqrt{T} Z) \f$.
+     * The growth factors \f$ g \f$ are generated once per small batch of paths and applied to
+     * every spot, streaming block by block, so the factors are never stored in full. Call and
+     * put payoffs are evaluated inline in a loop over the spots that vectorizes, so each extra
+     * spot costs a few arithmetic operations per path rather than a simulation. Each entry is
+     * identical to `calculatePrice()` of an engine started from that spot (common random
+     * numbers). With a result cache every spot has its own entry, shared with
+     * `calculatePrice()`; only spots not answered by the cache are simulated, from the earliest
+     * block any of them needs.
+     *
+     * @param spots Spot levels to price.
+     * @param numSimulations Number of paths (shared by all spots).
+     * @return One result per spot, in the same order.
+     */
+    [[nodiscard]] std::vector<PricingResult> calculateSpotLadder(
+        const std::vector<double>& spots, unsigned long long numSimulations) const;
+    /**
+     * @brief Risk ladder of relative spot shocks, e.g. {-0.2, ..., -0.01, 0, 0.01, ..., 0.2}.
+     *
+     * Convenience wrapper over calculateSpotLadder() with spots \f$ S_0 (1 + shock) \f$.
+     */
+    [[nodiscard]] std::vector<PricingResult> calculateSpotShocks(
+        const std::vector<double>& relativeShocks, unsigned long long numSimulations) const;
     /**
      * @brief Calculates price for Path-Dependent options (e.g., Asian).
      * Uses Euler-Maruyama discretization.
      * @param numSimulations Number of paths.
      * @param numSteps Number of time steps per path (e.g., 252 for daily monitoring).
+     * @throws std::invalid_argument If numSteps is 0.
      */
     [[nodiscard]] double calculateAsianPrice(unsigned long long numSimulations,
                                              unsigned int numSteps) const;
+    /**
+     * @brief Prices the European option with importance sampling.
+     *
+     * The normal driver is sampled from \f$ N(\mu, 1) \f$ and each payoff is weighted with
+     * the likelihood ratio \f$ e^{-\mu Z + \mu^2 / 2} \f$. The shift comes from
+     * importanceDrift(), so for deep out-of-the-money strikes most paths end in the exercise
+     * region. The plain-MC variance needed for the reported variance reduction is estimated
+     * from the same weighted samples (\f$ E[f^2] = E_\mu[f^2 L] \f$), at no extra cost.
+     * Runs in double precision without antithetic pairs and bypasses the result cache.
+     *
+     * @param numSimulations Number of paths.
+     * @throws std::runtime_error If importanceDrift() finds no shift.
+     */
+    [[nodiscard]] ImportanceSamplingResult calculatePriceIS(
+        unsigned long long numSimulations) const;
+    /**
+     * @brief Prices the Asian option with importance sampling (see calculatePriceIS()).
+     *
+     * Each of the `numSteps` Brownian increments gets its own shift.
+     * @throws std::invalid_argument If numSteps is 0.
+     * @throws std::runtime_error If importanceDrift() finds no shift.
+     */
+    [[nodiscard]] ImportanceSamplingResult calculateAsianPriceIS(unsigned long long numSimulations,
+                                                                 unsigned int numSteps) const;
+    /**
+     * @brief Optimal mean shift of the normal drivers from the payoff geometry.
+     *
+     * Maximises \f$ \log f(z) - |z|^2 / 2 \f$, the mode of the zero-variance sampling density
+     * \f$ \propto f(z) \varphi(z) \f$ (Glasserman, Heidelberger & Shahabuddin). A line search
+     * along the direction that moves the whole path finds a point where the payoff is positive;
+     * gradient ascent with step halving then converges to the fixed point
+     * \f$ z = \nabla_z \log f(z) \f$. No simulation is needed. The line search covers
+     * \f$ \pm 10 \f$ standard deviations and is widened up to \f$ \pm 40 \f$ until the payoff
+     * is positive; beyond that the exercise probability underflows double precision.
+     *
+     * @param numSteps 0 for the European terminal draw, otherwise the Asian time steps.
+     * @return One shift per step (a single element for European pricing).
+     * @throws std::runtime_error If the payoff is zero everywhere within \f$ \pm 40 \f$
+     * standard deviations (the estimate would be an exact-looking zero).
+     */
+    [[nodiscard]] std::vector<double> importanceDrift(unsigned int numSteps) const;
+    /**
+     * @brief Prices with stratified sampling of the leading normal driver.
+     *
+     * The terminal draw (European) or the first Brownian-bridge dimension, i.e. the terminal
+     * value of the Brownian path (Asian), is stratified into `numStrata` equiprobable strata
+     * \f$ z = \Phi^{-1}((k + U) / K) \f$; Asian paths are built with a Brownian bridge and the
+     * remaining dimensions are plain normals. Each sample is an antithetic pair, whose mirror
+     * lies in the mirrored stratum. Strata are the unit of work: each has its own RNG stream and
+     * they are spread across the engine's threads, so the result does not depend on the
+     * number of threads.
+     *
+     * The estimator is \f$ \sum_k p_k \bar y_k \f$ with standard error
+     * \f$ \sqrt{\sum_k p_k^2 s_k^2 / n_k} \f$. With Neyman allocation 10% of the pairs form a
+     * proportional pilot that only sets \f$ n_k \propto s_k \f$ and is not part of the estimate.
+     *
+     * @param numSimulations Path budget (pairs = numSimulations / 2).
+     * @param numSteps 0 for European pricing, otherwise the Asian time steps.
+     * @param numStrata Number of strata.
+     * @param allocation Proportional or Neyman allocation.
+     * @return Price, standard error and the number of paths in the estimate.
+     * @throws std::invalid_argument If numStrata is 0 or there are fewer than two pairs per
+     * stratum.
+     */
+    [[nodiscard]] PricingResult calculateStratifiedPrice(
+        unsigned long long numSimulations, unsigned int numSteps = 0, unsigned int numStrata = 64,
+        Allocation allocation = Allocation::Proportional) const;
+    /**
+     * @brief Prices with replicated Latin hypercube sampling.
+     *
+     * Each replicate of \f$ m \f$ antithetic pairs stratifies every one of the first
+     * `dimensions` normal drivers (the terminal draw for European pricing, the leading
+     * Brownian-bridge dimensions for Asian) into \f$ m \f$ equiprobable cells, with an
+     * independent random permutation per dimension. Replicate means are i.i.d., so the
+     * standard error is their sample standard deviation over \f$ \sqrt{R} \f$. Replicates have
+     * their own RNG streams and are spread across the engine's threads.
+     *
+     * @param numSimulations Path budget (pairs split evenly over the replicates).
+     * @param numSteps 0 for European pricing, otherwise the Asian time steps.
+     * @param dimensions Leading dimensions to stratify (clipped to the number of drivers).
+     * @param replicates Number of independent replicates R (at least 2).
+     * @throws std::invalid_argument If dimensions is 0, replicates < 2 or a replicate would
+     * have no pairs.
+     */
+    [[nodiscard]] PricingResult calculateLatinHypercubePrice(unsigned long long numSimulations,
+                                                             unsigned int numSteps = 0,
+                                                             unsigned int dimensions = 4,
+                                                             unsigned int replicates = 32) const;
+    /**
+     * @brief Price, delta, vega, rho and per-step vega buckets of the Asian option in one
+     * forward + reverse pass (adjoint pathwise method).
+     *
+     * The forward sweep is the calculateAsianPrice() kernel and records, per path, the spots
+     * \f$ S_{j+1} \f$ and the local vol sensitivities \f$ \sqrt{dt} Z_j - \sigma dt \f$. The
+     * hand-written reverse sweep then propagates \f$ \bar S_j = \partial Y / \partial S_j \f$
+     * from maturity back to \f$ S_0 \f$, collecting all sensitivities on the way, so the cost
+     * is a small constant multiple of the price alone regardless of the number of buckets.
+     * The tape covers one batch of paths and is owned by the worker thread, so memory is bounded
+     * by `2 * batch * numSteps` doubles per thread.
+     *
+     * Always runs in double precision and bypasses the result cache; the price is identical to
+     * calculateAsianPrice() in double precision.
+     *
+     * @param numSimulations Number of paths.
+     * @param numSteps Number of time steps (and vega buckets).
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    [[nodiscard]] AsianSensitivities calculateAsianSensitivities(unsigned long long numSimulations,
+                                                                 unsigned int numSteps) const;
+    /**
+     * @brief Non-blocking calculatePrice(): starts the calculation and returns immediately.
+     *
+     * The calculation runs on a copy of the engine, so the engine may be modified or destroyed
+     * afterwards. Threads take RNG blocks one at a time and publish each finished block to the
+     * handle's progress; a completed run gives exactly the calculatePrice() result. The result
+     * cache is not consulted.
+     *
+     * @param numSimulations Number of paths.
+     * @return Handle with the future result, progress and cancellation.
+     */
+    [[nodiscard]] PricingHandle calculatePriceAsync(unsigned long long numSimulations) const;
+    /**
+     * @brief Non-blocking calculateAsianPrice() (see calculatePriceAsync()).
+     * @throws std::invalid_argument If numSteps is 0.
+     */
+    [[nodiscard]] PricingHandle calculateAsianPriceAsync(unsigned long long numSimulations,
+                                                         unsigned int numSteps) const;
+    /**
+     * @brief Prices the Asian option with the adaptive **Multilevel Monte Carlo** method (Giles).
+     *
+     * Level \f$ l \f$ simulates coupled fine/coarse paths with \f$ 2^l \f$ and \f$ 2^{l-1} \f$
+     * steps driven by the same Brownian increments, so the corrections \f$ P_l - P_{l-1} \f$
+     * have small variance and most paths run on cheap coarse grids. Per-level variances are
+     * estimated online and the number of paths per level is chosen as
+     * \f[
+     * N_l = \left\lceil 2 \varepsilon^{-2} \sqrt{V_l / C_l} \sum_k \sqrt{V_k C_k} \right\rceil,
+     * \f]
+     * which minimises the total cost for a target RMSE \f$ \varepsilon \f$. Levels are added
+     * until the estimated bias drops below \f$ \varepsilon / \sqrt{2} \f$, giving a cost of
+     * about \f$ O(\varepsilon^{-2}) \f$ instead of \f$ O(\varepsilon^{-3}) \f$.
+     *
+     * The average is taken with the trapezoidal rule, so the estimator converges to the
+     * continuously monitored arithmetic average; for the discrete average over
+     * \f$ t_1..t_N \f$ priced by calculateAsianPrice() use calculateDiscreteAsianPriceMLMC().
+     * Each level runs on the engine's threads.
+     *
+     * @param targetRmse Target root mean square error \f$ \varepsilon \f$ of the price.
+     * @param maxLevel Finest admissible level (at most \f$ 2^{maxLevel} \f$ steps).
+     * @param pilotPaths Number of paths used for the initial variance estimate on each level.
+     * @return Price together with the per-level cost breakdown.
+     * @throws std::invalid_argument If targetRmse <= 0, pilotPaths < 2 or maxLevel < 2.
+     */
+    [[nodiscard]] MLMCResult calculateAsianPriceMLMC(double targetRmse, unsigned int maxLevel = 12,
+                                                     unsigned long long pilotPaths = 10'000) const;
+    /**
+     * @brief MLMC for the discretely monitored average of calculateAsianPrice(numSteps).
+     *
+     * The levels refine the set of monitoring dates instead of a time grid. With
+     * \f$ L = \lceil \log_2 N \rceil \f$, level \f$ l \f$ averages every
+     * \f$ s = 2^{L-l} \f$-th date counted back from \f$ t_N \f$, each weighted by s (the
+     * earliest one by the remaining dates), and its coarse partner takes every second of
+     * those dates from the same exact GBM path. Level 0 is the European payoff on
+     * \f$ S_T \f$ and level L is the contract itself, so the estimator is unbiased once the
+     * adaptive scheme (see calculateAsianPriceMLMC()) reaches level L.
+     *
+     * @param targetRmse Target root mean square error of the price.
+     * @param numSteps Number of monitoring dates N.
+     * @param pilotPaths Number of paths used for the initial variance estimate on each level.
+     * @return Price with the per-level breakdown; `steps` is the number of dates of a level.
+     * @throws std::invalid_argument If targetRmse <= 0, numSteps is 0 or pilotPaths < 2.
+     */
+    [[nodiscard]] MLMCResult calculateDiscreteAsianPriceMLMC(
+        double targetRmse, unsigned int numSteps, unsigned long long pilotPaths = 10'000) const;
     /**
      * @brief Manually sets the number of threads for simulation.
      *
@@ -92,6 +393,102 @@ class MonteCarloEngine {
      * @param threads Number of threads. If 0, resets to `std::thread::hardware_concurrency()`.
      */
     void setNumThreads(unsigned int threads);
+    /**
+     * @brief Attaches a result cache (nullptr detaches).
+     *
+     * calculatePrice(), calculateAsianPrice(), calculateSpotLadder() (one entry per spot) and
+     * calculateGreeks() then look up the accumulated sums for the same payoff, spot, market
+     * data, seed and steps. An identical request is answered without simulation; a request
+     * for more paths continues the deterministic RNG block sequence and simulates only the
+     * missing blocks. The result is identical to an uncached run.
+     *
+     * The payoff is identified by its name() and strike(), so only the built-in payoff types
+     * are cached (see isBuiltinPayoff()); engines with other payoffs ignore the cache.
+     *
+     * @param cache Shared cache; may be shared between engines and threads.
+     */
+    void setResultCache(std::shared_ptr<ResultCache> cache);
+    /**
+     * @brief Streams the normals of the European and Asian kernels from a variate bank
+     * (nullptr detaches).
+     *
+     * Blocks the bank covers (same seed and normal method, enough variates) are read from the
+     * mapping in place; the others are generated live. The bank holds the live stream, so
+     * results are bit-identical with and without it.
+     *
+     * @param bank Shared bank; may be shared between engines and threads.
+     */
+    void setVariateBank(std::shared_ptr<const VariateBank> bank);
+    /**
+     * @brief Selects the precision policy of the European and Asian kernels.
+     *
+     * With Precision::Single normals are drawn and paths are evolved in `float`; payoffs
+     * and all sums are accumulated in double (per-batch sums combined with compensated
+     * summation), so the estimate stays within a small fraction of one standard error of the
+     * double-precision result. MLMC and the sharded workers always run in double.
+     */
+    void setPrecision(Precision precision) noexcept;
+    /// @brief Current precision policy.
+    [[nodiscard]] Precision precision() const noexcept;
+    /**
+     * @brief Selects how normal variates are generated (Ziggurat by default).
+     *
+     * Both methods are platform-independent; they consume the RNG stream differently, so the
+     * two give different (equally valid) estimates for the same seed.
+     */
+    void setNormalMethod(NormalMethod method) noexcept;
+    /// @brief Current normal generation method.
+    [[nodiscard]] NormalMethod normalMethod() const noexcept;
+    /**
+     * @brief Replaces the constant rate with a piecewise-constant short-rate curve.
+     *
+     * Drift and discounting use \f$ \int r(t)\,dt \f$ over each time step; a flat curve is
+     * equivalent to the constructor's rate.
+     */
+    void setRateCurve(PiecewiseConstantCurve curve);
+    /**
+     * @brief Replaces the constant volatility with a piecewise-constant volatility curve.
+     *
+     * Each step diffuses with the integrated variance \f$ \int \sigma(t)^2\,dt \f$, so the
+     * European kernel stays exact with a single step.
+     * @throws std::invalid_argument If a volatility is negative.
+     */
+    void setVolCurve(PiecewiseConstantCurve curve);
+    /**
+     * @brief Discrete dividends paid before maturity (dividends after T are ignored).
+     *
+     * Escrowed-dividend model: the simulated process is the spot less the present value of the
+     * cash dividends still to be paid, \f$ S_t = \tilde S_t + \sum_{t < t_i \le T} D_i
+     * e^{-\int_t^{t_i} r} \f$, and a proportional dividend \f$ \delta \f$ multiplies
+     * \f$ \tilde S \f$ by \f$ 1 - \delta \f$ on the step containing its ex-date.
+     * @throws std::invalid_argument If an ex-date is not positive, a cash amount is negative or
+     * a proportional fraction is outside [0, 1).
+     */
+    void setDividends(std::vector<Dividend> dividends);
+    /// @brief True if a non-flat curve or a dividend is set.
+    [[nodiscard]] bool hasTermStructure() const noexcept;
+    /**
+     * @brief Simulates a contiguous range of RNG blocks and returns per-block statistics.
+     *
+     * Building block of distributed execution: a job of `numSimulations` paths consists of
+     * `blockCount(numSimulations)` blocks, any range of which can be computed independently.
+     * Reducing all block statistics with reduceBlocks() reproduces calculatePrice() /
+     * calculateAsianPrice() exactly.
+     *
+     * @param firstBlock First block of the range.
+     * @param lastBlock One past the last block of the range.
+     * @param numSimulations Total number of paths of the whole job (sizes the last block).
+     * @param numSteps 0 for European (terminal) pricing, otherwise the Asian time steps.
+     * @return Undiscounted statistics of each block, in block order.
+     */
+    [[nodiscard]] std::vector<PathStatistics> simulateBlocks(unsigned long long firstBlock,
+                                                             unsigned long long lastBlock,
+                                                             unsigned long long numSimulations,
+                                                             unsigned int numSteps = 0) const;
+    /// @brief Discount factor \f$ e^{-\int_0^T r(t)\,dt} \f$ applied to the mean payoff.
+    [[nodiscard]] double discountFactor() const noexcept;
+    /// @brief Payoff being priced.
+    [[nodiscard]] const Payoff& payoff() const noexcept { return *m_payoff; }
 
    private:
     std::shared_ptr<Payoff> m_payoff;
@@ -103,11 +500,45 @@ class MonteCarloEngine {
 
     /// @brief Current number of threads used for execution.
     unsigned int m_numThreads;
+    /// @brief Optional cache of accumulated statistics.
+    std::shared_ptr<ResultCache> m_cache;
+    /// @brief Optional bank of precomputed normals (null = live generation).
+    std::shared_ptr<const VariateBank> m_variateBank;
+    /// @brief Floating-point type of the path kernels.
+    Precision m_precision = Precision::Double;
+    /// @brief Uniform-to-normal transformation used by all kernels.
+    NormalMethod m_normalMethod = NormalMethod::Ziggurat;
+    /// @brief Short-rate curve (flat at m_r unless set).
+    PiecewiseConstantCurve m_rateCurve;
+    /// @brief Volatility curve (flat at m_sigma unless set).
+    PiecewiseConstantCurve m_volCurve;
+    /// @brief Discrete dividends, sorted by ex-date.
+    std::vector<Dividend> m_dividends;
+
+    /**
+     * @struct StepTables
+     * @brief Per-step coefficients of the log-spot evolution, built once per pricing call.
+     *
+     * Step j advances \f$ \log \tilde S \f$ by `drift[j] + diffusion[j] * Z`; `escrow[j]` is
+     * the value of the outstanding cash dividends at the end of step j.
+     */
+    struct StepTables {
+        std::vector<double> drift;
+        std::vector<double> diffusion;
+        std::vector<double> escrow;
+        double escrow0 = 0.0;  ///< Present value of all cash dividends at t = 0.
+    };
+
+    /// @brief Step tables for numSteps equal steps (0: one step to maturity).
+    [[nodiscard]] StepTables buildStepTables(unsigned int numSteps) const;
+    /// @brief Throws std::logic_error if a method that assumes constant parameters is used with
+    /// a term structure.
+    void requireFlatParameters(const char* method) const;
     /**
      * @brief Internal wrapper to run simulation for a specific Spot Price.
      *
      * Handles the distribution of workload across threads.
-     * Used internally by `calculatePrice` (with S0) and `calculateGreeks` (with S0 +/- h).
+     * Used internally by `calculatePrice` (with S0).
      *
      * @param spot The spot price to start simulation from.
      * @param numSimulations Total number of paths.
@@ -115,20 +546,180 @@ class MonteCarloEngine {
      */
     [[nodiscard]] double runSimulationForSpot(double spot, unsigned long long numSimulations) const;
     /**
-     * @brief Executes a chunk of simulations on a single thread.
+     * @brief Statistics of a full run, served from the result cache when possible.
+     * @param spot The starting spot price.
+     * @param numSteps 0 for European, otherwise Asian time steps.
+     * @param numSimulations Total number of paths.
+     * @return Undiscounted statistics of all blocks, reduced in block order.
+     */
+    [[nodiscard]] PathStatistics simulateStatistics(double spot, unsigned int numSteps,
+                                                    unsigned long long numSimulations) const;
+    /// @brief Whether runs use the result cache: one is attached and the payoff is built-in.
+    [[nodiscard]] bool cacheable() const noexcept;
+    /// @brief Canonical cache key of a run (all doubles bit-exact).
+    [[nodiscard]] std::string cacheKey(double spot, unsigned int numSteps) const;
+    /// @brief First block a cached run has to simulate: the end of a reusable prefix, else 0.
+    [[nodiscard]] static unsigned long long resumeBlock(const std::optional<CacheEntry>& cached,
+                                                        unsigned long long numSimulations) noexcept;
+    /**
+     * @brief Folds freshly simulated blocks into the cache entry of a run and stores it.
+     * @param key Cache key of the run.
+     * @param cached Entry found under the key before simulating (if any).
+     * @param blocks Statistics of blocks [firstBlock, blockCount(numSimulations)); firstBlock
+     * must not exceed resumeBlock(cached, numSimulations).
+     * @return Undiscounted statistics of the whole run.
+     */
+    [[nodiscard]] PathStatistics storeBlocks(const std::string& key,
+                                             const std::optional<CacheEntry>& cached,
+                                             const std::vector<PathStatistics>& blocks,
+                                             unsigned long long firstBlock,
+                                             unsigned long long numSimulations) const;
+    /**
+     * @brief Simulates one RNG block of European paths on a single thread.
      *
      * Implements the **Antithetic Variates** method: for every random draw \f$ Z \f$,
      * it calculates paths for both \f$ Z \f$ and \f$ -Z \f$ to reduce variance.
+     * Each antithetic pair forms one sample. Paths are processed in batches: normals,
+     * terminal spots and payoffs are computed in separate loops over `Real` arrays and batch
+     * sums are accumulated in double (see BlockAccumulator).
      *
+     * @tparam Real `double` or `float` (see Precision).
+     * @param spot The starting spot price (dividend escrow already removed).
+     * @param block Block index, used to address the RNG stream.
+     * @param numPaths Number of paths in this block.
+     * @param tables Single-step coefficients (see buildStepTables()).
+     * @return Undiscounted statistics of the block.
+     */
+    template <typename Real>
+    [[nodiscard]] PathStatistics runSimulationChunk(double spot, unsigned long long block,
+                                                    unsigned long long numPaths,
+                                                    const StepTables& tables) const;
+    /**
+     * @brief Simulates one RNG block of Asian paths on a single thread.
+     *
+     * A batch of paths is advanced in lockstep, one vectorisable loop over paths per step.
+     * @tparam Real `double` or `float` (see Precision).
+     * @param block Block index, used to address the RNG stream.
+     * @param numPaths Number of paths in this block.
+     * @param numSteps Number of time steps per path.
+     * @param tables Per-step coefficients (see buildStepTables()).
+     * @return Undiscounted statistics of the block (one sample per path).
+     */
+    template <typename Real>
+    [[nodiscard]] PathStatistics runAsianChunk(unsigned long long block,
+                                               unsigned long long numPaths, unsigned int numSteps,
+                                               const StepTables& tables) const;
+    /**
+     * @brief Simulates one RNG block of European paths for a ladder of spots.
+     *
+     * Uses the same RNG stream as runSimulationChunk(); growth factors are generated in
+     * small batches and reused for every spot.
+     * @return Undiscounted statistics of the block for each spot.
+     */
+    template <typename Real>
+    [[nodiscard]] std::vector<PathStatistics> runLadderChunk(const std::vector<double>& spots,
+                                                             unsigned long long block,
+                                                             unsigned long long numPaths,
+                                                             const StepTables& tables) const;
+    /**
+     * @brief Splits blocks [0, numBlocks) into contiguous ranges, one per thread.
+     * @param fn Called as fn(begin, end) on each thread.
+     */
+    void parallelForBlocks(
+        unsigned long long numBlocks,
+        const std::function<void(unsigned long long, unsigned long long)>& fn) const;
+    /**
+     * @brief Undiscounted antithetic pair payoff for the drivers z (bridge order for Asian).
+     * @param path Scratch space of numSteps doubles.
+     */
+    [[nodiscard]] double pairPayoff(const std::vector<double>& z, unsigned int numSteps,
+                                    const BrownianBridge* bridge, std::vector<double>& path) const;
+
+    /// @brief Simulates `numPairs` pairs of stratum k out of numStrata.
+    [[nodiscard]] PathStatistics runStratum(unsigned int stratum, unsigned int numStrata,
+                                            unsigned long long numPairs, unsigned int numSteps,
+                                            uint32_t domain) const;
+
+    /// @brief Undiscounted mean of one Latin hypercube replicate of numPairs pairs.
+    [[nodiscard]] double runLatinReplicate(unsigned int replicate, unsigned long long numPairs,
+                                           unsigned int numSteps, unsigned int dimensions) const;
+
+    /// @brief Undiscounted per-block sums of an importance-sampling run.
+    struct ImportanceSums {
+        PathStatistics weighted;     ///< Samples \f$ f L \f$.
+        double plainSecondMoment;    ///< \f$ \sum f^2 L \f$, estimates \f$ E[f^2] \f$.
+    };
+
+    /// @brief Shifted-driver simulation of one RNG block (numSteps == 0: European).
+    [[nodiscard]] ImportanceSums runImportanceChunk(unsigned long long block,
+                                                    unsigned long long numPaths,
+                                                    unsigned int numSteps,
+                                                    const std::vector<double>& drift) const;
+
+    /// @brief Runs importance sampling with the automatic drift.
+    [[nodiscard]] ImportanceSamplingResult runImportanceSampling(unsigned long long numSimulations,
+                                                                 unsigned int numSteps) const;
+
+    /// @brief Undiscounted per-block sums of the adjoint Asian run.
+    struct AdjointSums {
+        PathStatistics payoff;
+        double delta = 0.0;
+        double rho = 0.0;  ///< Without the discounting term.
+        std::vector<double> bucketVega;
+    };
+
+    /// @brief Forward + reverse sweep over one RNG block of Asian paths.
+    [[nodiscard]] AdjointSums runAsianAdjointChunk(unsigned long long block,
+                                                   unsigned long long numPaths,
+                                                   unsigned int numSteps) const;
+
+    /// @brief Simulates one RNG block with the kernel selected by numSteps and the precision.
+    [[nodiscard]] PathStatistics runBlock(double spot, unsigned int numSteps,
+                                          unsigned long long block,
+                                          unsigned long long numSimulations,
+                                          const StepTables& tables) const;
+
+    /**
+     * @brief Cancellable run behind the async API.
+     *
+     * Threads take blocks dynamically and check the cancellation flag before each one. The
+     * finished blocks are folded in block order.
+     */
+    [[nodiscard]] PricingResult runCancellable(double spot, unsigned int numSteps,
+                                               unsigned long long numSimulations,
+                                               PricingState& state) const;
+
+    /**
+     * @brief Distributes a range of blocks across the engine's threads.
      * @param spot The starting spot price.
-     * @param numPaths Number of paths for this specific chunk.
-     * @param chunkIndex Thread index, used to offset the RNG seed for thread-safety.
-     * @return Sum of payoffs for this chunk (undiscounted, un-averaged).
-     */
-    [[nodiscard]] double runSimulationChunk(double spot, unsigned long long numPaths,
-                                            unsigned long long chunkIndex) const;
-    [[nodiscard]] double runAsianChunk(unsigned long long numPaths, unsigned int numSteps,
-                                       unsigned long long chunkIndex) const;
+     * @param numSteps 0 for European, otherwise Asian time steps.
+     * @return Per-block statistics in block order.
+     */
+    [[nodiscard]] std::vector<PathStatistics> runBlocks(double spot, unsigned int numSteps,
+                                                        unsigned long long firstBlock,
+                                                        unsigned long long lastBlock,
+                                                        unsigned long long numSimulations) const;
+    /**
+     * @brief Simulates coupled fine/coarse Asian paths for one MLMC level on a single thread.
+     *
+     * @param level MLMC level (fine grid has \f$ 2^{level} \f$ steps, or the level's
+     * monitoring dates of the discrete average).
+     * @param numSteps 0 for the continuous average, otherwise the monitoring dates.
+     * @param numPaths Number of path pairs for this chunk.
+     * @param streamId Unique stream identifier (batch and thread), used to seed the RNG.
+     * @return Sum and sum of squares of the discounted corrections \f$ P_l - P_{l-1} \f$.
+     */
+    [[nodiscard]] std::pair<double, double> runMLMCLevelChunk(unsigned int level,
+                                                              unsigned int numSteps,
+                                                              unsigned long long numPaths,
+                                                              unsigned long long streamId) const;
+    /**
+     * @brief Adaptive MLMC driver shared by the continuous and discrete Asian estimators.
+     * @param maxLevel Finest admissible level.
+     * @param numSteps 0 for the continuous average, otherwise the monitoring dates.
+     */
+    [[nodiscard]] MLMCResult runMLMC(double targetRmse, unsigned int maxLevel,
+                                     unsigned long long pilotPaths, unsigned int numSteps) const;
 };
 
 }  // namespace mcopt
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "NormalGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace mcopt {
+
+namespace {
+
+// ==========================================
+// Переносимые log/exp (по мотивам fdlibm)
+// ==========================================
+// Только корректно округляемые операции IEEE 754 — результат одинаков на всех платформах.
+
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double INV_LN2 = 1.44269504088896338700e+00;
+constexpr double SQRT_HALF = 0.70710678118654752440;
+
+// Натуральный логарифм для конечного x > 0 (ошибка < 1 ulp)
+double portableLog(double x) noexcept {
+    constexpr double Lg1 = 6.666666666666735130e-01;
+    constexpr double Lg2 = 3.999999999940941908e-01;
+    constexpr double Lg3 = 2.857142874366239149e-01;
+    constexpr double Lg4 = 2.222219843214978396e-01;
+    constexpr double Lg5 = 1.818357216161805012e-01;
+    constexpr double Lg6 = 1.531383769920937332e-01;
+    constexpr double Lg7 = 1.479819860511658591e-01;
+
+    int e = 0;
+    double m = std::frexp(x, &e);  // x = m * 2^e, m в [0.5, 1)
+    if (m < SQRT_HALF) {
+        m *= 2.0;
+        --e;
+    }
+    double f = m - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+    double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+    double R = t2 + t1;
+    double hfsq = 0.5 * f * f;
+    double k = static_cast<double>(e);
+    return k * LN2_HI - ((hfsq - (s * (hfsq + R) + k * LN2_LO)) - f);
+}
+
+// Экспонента для умеренных аргументов (|x| < 700)
+double portableExp(double x) noexcept {
+    constexpr double P1 = 1.66666666666666019037e-01;
+    constexpr double P2 = -2.77777777770155933842e-03;
+    constexpr double P3 = 6.61375632143793436117e-05;
+    constexpr double P4 = -1.65339022054652515390e-06;
+    constexpr double P5 = 4.13813679705723846039e-08;
+
+    double k = std::floor(x * INV_LN2 + 0.5);
+    double hi = x - k * LN2_HI;
+    double lo = k * LN2_LO;
+    double r = hi - lo;
+    double t = r * r;
+    double c = r - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+    double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+    return std::ldexp(y, static_cast<int>(k));
+}
+
+// ==========================================
+// Таблицы Ziggurat (128 слоев, Marsaglia–Tsang в варианте Doornik)
+// ==========================================
+
+constexpr int ZIG_LAYERS = 128;
+constexpr double ZIG_R = 3.442619855899;           // Начало хвоста
+constexpr double ZIG_V = 9.91256303526217e-3;      // Площадь одного слоя
+
+struct ZigguratTables {
+    std::array<double, ZIG_LAYERS + 1> x{};  // Правые границы слоев
+    std::array<double, ZIG_LAYERS> ratio{};  // x[i+1] / x[i]: доля слоя внутри кривой
+
+    ZigguratTables() noexcept {
+        double f = portableExp(-0.5 * ZIG_R * ZIG_R);
+        x[0] = ZIG_V / f;  // Нижний слой вместе с хвостом
+        x[1] = ZIG_R;
+        x[ZIG_LAYERS] = 0.0;
+        for (int i = 2; i < ZIG_LAYERS; ++i) {
+            x[i] = std::sqrt(-2.0 * portableLog(ZIG_V / x[i - 1] + f));
+            f = portableExp(-0.5 * x[i] * x[i]);
+        }
+        for (int i = 0; i < ZIG_LAYERS; ++i) {
+            ratio[i] = x[i + 1] / x[i];
+        }
+    }
+};
+
+const ZigguratTables& zigguratTables() {
+    static const ZigguratTables tables;
+    return tables;
+}
+
+// ==========================================
+// Wichura AS241 (PPND16)
+// ==========================================
+
+constexpr double SPLIT_CENTRAL = 0.425;
+constexpr double SPLIT_TAIL = 5.0;
+
+inline double centralRegion(double q) noexcept {
+    double r = 0.180625 - q * q;
+    double num = ((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r +
+                      6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r +
+                    1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r +
+                  1.3314166789178437745e+2) * r + 3.3871328727963666080e+0;
+    double den = ((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r +
+                      3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r +
+                    5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r +
+                  4.2313330701600911252e+1) * r + 1.0;
+    return q * num / den;
+}
+
+inline double tailRegion(double q, double p) noexcept {
+    double r = std::min(p, 1.0 - p);
+    if (r <= 0.0) {
+        return q < 0.0 ? -std::numeric_limits<double>::infinity()
+                       : std::numeric_limits<double>::infinity();
+    }
+    r = std::sqrt(-portableLog(r));
+    double value = 0.0;
+    if (r <= SPLIT_TAIL) {
+        r -= 1.6;
+        double num = ((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r +
+                          2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r +
+                        3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r +
+                      4.63033784615654529590e+0) * r + 1.42343711074968357734e+0;
+        double den = ((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r +
+                          1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r +
+                        6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r +
+                      2.05319162663775882187e+0) * r + 1.0;
+        value = num / den;
+    } else {
+        r -= 5.0;
+        double num = ((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r +
+                          1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r +
+                        2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r +
+                      5.46378491116411436990e+0) * r + 6.65790464350110377720e+0;
+        double den = ((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r +
+                          1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r +
+                        1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r +
+                      5.99832206555887937690e-1) * r + 1.0;
+        value = num / den;
+    }
+    return q < 0.0 ? -value : value;
+}
+
+// Размер внутреннего буфера равномерных величин для пакетного режима
+constexpr std::size_t UNIFORM_BATCH = 256;
+
+}  // namespace
+
+NormalGenerator::NormalGenerator(NormalMethod method) noexcept : m_method(method) {
+    if (m_method == NormalMethod::Ziggurat) {
+        zigguratTables();  // Таблицы строятся один раз, до первой генерации
+    }
+}
+
+double NormalGenerator::uniform(uint64_t bits) noexcept {
+    // Середина одной из 2^53 ячеек: никогда не равна 0 или 1
+    return (static_cast<double>(bits >> 11) + 0.5) * 0x1.0p-53;
+}
+
+double NormalGenerator::ziggurat(std::mt19937_64& rng) const {
+    const ZigguratTables& t = zigguratTables();
+    for (;;) {
+        uint64_t bits = rng();
+        auto layer = static_cast<int>(bits & 0x7F);  // Младшие 7 бит: слой
+        double u = 2.0 * uniform(bits) - 1.0;        // Старшие 53 бита: позиция в слое
+
+        // Быстрый путь: точка внутри прямоугольника под кривой
+        if (std::abs(u) < t.ratio[layer]) return u * t.x[layer];
+
+        if (layer == 0) {
+            // Хвост |z| > R (метод Marsaglia)
+            double x = 0.0;
+            double y = 0.0;
+            do {
+                x = portableLog(uniform(rng())) / ZIG_R;
+                y = portableLog(uniform(rng()));
+            } while (-2.0 * y < x * x);
+            return u < 0.0 ? x - ZIG_R : ZIG_R - x;
+        }
+
+        // Клин между прямоугольником и кривой
+        double x = u * t.x[layer];
+        double f0 = portableExp(-0.5 * (t.x[layer] * t.x[layer] - x * x));
+        double f1 = portableExp(-0.5 * (t.x[layer + 1] * t.x[layer + 1] - x * x));
+        if (f1 + uniform(rng()) * (f0 - f1) < 1.0) return x;
+    }
+}
+
+double NormalGenerator::operator()(std::mt19937_64& rng) const {
+    if (m_method == NormalMethod::Ziggurat) return ziggurat(rng);
+    return inverseCdf(uniform(rng()));
+}
+
+void NormalGenerator::fill(std::mt19937_64& rng, double* out, std::size_t n) const {
+    if (m_method == NormalMethod::Ziggurat) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = ziggurat(rng);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = uniform(rng());
+    }
+    inverseCdf(out, out, n);
+}
+
+void NormalGenerator::fill(std::mt19937_64& rng, float* out, std::size_t n) const {
+    std::array<double, UNIFORM_BATCH> buffer{};
+    for (std::size_t start = 0; start < n; start += UNIFORM_BATCH) {
+        std::size_t m = std::min(UNIFORM_BATCH, n - start);
+        fill(rng, buffer.data(), m);
+        for (std::size_t i = 0; i < m; ++i) {
+            out[start + i] = static_cast<float>(buffer[i]);
+        }
+    }
+}
+
+double NormalGenerator::inverseCdf(double p) noexcept {
+    double q = p - 0.5;
+    if (std::abs(q) <= SPLIT_CENTRAL) return centralRegion(q);
+    return tailRegion(q, p);
+}
+
+void NormalGenerator::inverseCdf(const double* u, double* z, std::size_t n) noexcept {
+    std::array<double, UNIFORM_BATCH> p{};
+    for (std::size_t start = 0; start < n; start += UNIFORM_BATCH) {
+        std::size_t m = std::min(UNIFORM_BATCH, n - start);
+        std::copy(u + start, u + start + m, p.begin());  // Вход и выход могут совпадать
+
+        // Проход 1: центральная формула для всех элементов (без ветвлений, векторизуется)
+        for (std::size_t i = 0; i < m; ++i) {
+            double q = std::min(std::max(p[i] - 0.5, -SPLIT_CENTRAL), SPLIT_CENTRAL);
+            z[start + i] = centralRegion(q);
+        }
+        // Проход 2: хвосты (около 15% элементов)
+        for (std::size_t i = 0; i < m; ++i) {
+            double q = p[i] - 0.5;
+            if (std::abs(q) > SPLIT_CENTRAL) z[start + i] = tailRegion(q, p[i]);
+        }
+    }
+}
+
+}  // namespace mcopt
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+/**
+ * @file NormalGenerator.hpp
+ * @brief Собственный блочный генератор нормальных величин (Ziggurat и обратная функция
+ * распределения).
+ *
+ * В отличие от `std::normal_distribution`, результат полностью определен стандартом IEEE 754:
+ * используются только `+ - * /`, `sqrt`, `floor`, `frexp`/`ldexp` и собственные `log`/`exp`,
+ * поэтому последовательность совпадает на всех компиляторах и платформах.
+ */
+
+namespace mcopt {
+
+/**
+ * @enum NormalMethod
+ * @brief Transformation of uniform bits into standard normal variates.
+ */
+enum class NormalMethod {
+    Ziggurat,   ///< Marsaglia–Tsang ziggurat (128 layers): one 64-bit draw for ~99% of variates.
+    InverseCdf  ///< Wichura AS241 inverse CDF: one uniform per variate, monotone in the input.
+};
+
+/**
+ * @class NormalGenerator
+ * @brief Fills blocks of standard normal variates from a `std::mt19937_64` stream.
+ *
+ * The generator holds no state besides the method, so a kernel can create one per RNG block.
+ * The inverse-CDF mode consumes exactly one 64-bit draw per variate and is also available as a
+ * pure transform of uniforms (inverseCdf()), e.g. for quasi-random points or counter-based
+ * generators.
+ */
+class NormalGenerator {
+   public:
+    explicit NormalGenerator(NormalMethod method = NormalMethod::Ziggurat) noexcept;
+
+    /// @brief Selected method.
+    [[nodiscard]] NormalMethod method() const noexcept { return m_method; }
+
+    /// @brief Draws one standard normal variate.
+    [[nodiscard]] double operator()(std::mt19937_64& rng) const;
+
+    /// @brief Fills out[0..n) with standard normal variates.
+    void fill(std::mt19937_64& rng, double* out, std::size_t n) const;
+    /// @brief Single-precision overload: variates are generated in double and rounded.
+    void fill(std::mt19937_64& rng, float* out, std::size_t n) const;
+
+    /**
+     * @brief Inverse of the standard normal CDF (Wichura AS241, relative error ~1e-16).
+     * @param p Probability in (0, 1); 0 and 1 map to -/+ infinity.
+     */
+    [[nodiscard]] static double inverseCdf(double p) noexcept;
+
+    /**
+     * @brief Batch inverse CDF: z[i] = inverseCdf(u[i]).
+     *
+     * The central region (about 85% of inputs) is evaluated for all elements in one
+     * branch-free loop; the tails are patched in a second pass.
+     */
+    static void inverseCdf(const double* u, double* z, std::size_t n) noexcept;
+
+    /// @brief Uniform in the open interval (0, 1) from the top 53 bits of one draw.
+    [[nodiscard]] static double uniform(uint64_t bits) noexcept;
+
+   private:
+    [[nodiscard]] double ziggurat(std::mt19937_64& rng) const;
+
+    NormalMethod m_method;
+};
+
+}  // namespace mcopt
@@ -1,9 +1,29 @@
 #include "Payoff.hpp"
 
+#include <stdexcept>
+#include <typeinfo>
+
 namespace mcopt {
 
 double PayoffCall::operator()(double spot) const noexcept { return std::max(spot - m_strike, 0.0); }
 
+double PayoffCall::derivative(double spot) const noexcept { return spot > m_strike ? 1.0 : 0.0; }
+
 double PayoffPut::operator()(double spot) const noexcept { return std::max(m_strike - spot, 0.0); }
 
+double PayoffPut::derivative(double spot) const noexcept { return spot < m_strike ? -1.0 : 0.0; }
+
+std::shared_ptr<Payoff> makePayoff(const std::string& name, double strike) {
+    if (name == "Call") return std::make_shared<PayoffCall>(strike);
+    if (name == "Put") return std::make_shared<PayoffPut>(strike);
+    if (name == "Asian Call") return std::make_shared<PayoffAsianCall>(strike);
+    throw std::invalid_argument("Unknown payoff type: " + name);
+}
+
+bool isBuiltinPayoff(const Payoff& payoff) noexcept {
+    const std::type_info& type = typeid(payoff);
+    return type == typeid(PayoffCall) || type == typeid(PayoffPut) ||
+           type == typeid(PayoffAsianCall);
+}
+
 }  // namespace mcopt
\ No newline at end of file
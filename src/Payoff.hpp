@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>  // std::max
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <string>
 
 /**
@@ -39,6 +42,29 @@ class Payoff {
      * @return String representation (e.g., "Call", "Put"). Useful for logging/debugging.
      */
     [[nodiscard]] virtual std::string name() const = 0;
+
+    /**
+     * @brief Derivative of the payoff with respect to its argument.
+     *
+     * Used by pathwise (adjoint) sensitivities; at the kink (a null set) it is taken as 0.
+     * The default is the central difference with step \f$ h = 10^{-6} \max(1, |S|) \f$;
+     * override it with the exact derivative where one is known.
+     */
+    [[nodiscard]] virtual double derivative(double spot) const noexcept {
+        const double h = 1e-6 * std::max(1.0, std::abs(spot));
+        return ((*this)(spot + h) - (*this)(spot - h)) / (2.0 * h);
+    }
+
+    /**
+     * @brief Returns the strike price \f$ K \f$ of the contract.
+     *
+     * Together with name() it fully describes the built-in payoffs, see makePayoff(). The
+     * default is NaN ("no single strike"); features that need a strike (the European control
+     * variate of JumpDiffusionEngine) are then skipped.
+     */
+    [[nodiscard]] virtual double strike() const noexcept {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
 };
 
 /**
@@ -61,6 +87,8 @@ class PayoffCall : public Payoff {
 
     [[nodiscard]] double operator()(double spot) const noexcept override;
     [[nodiscard]] std::string name() const override { return "Call"; }
+    [[nodiscard]] double derivative(double spot) const noexcept override;
+    [[nodiscard]] double strike() const noexcept override { return m_strike; }
 
    private:
     double m_strike;
@@ -86,6 +114,8 @@ class PayoffPut : public Payoff {
 
     [[nodiscard]] double operator()(double spot) const noexcept override;
     [[nodiscard]] std::string name() const override { return "Put"; }
+    [[nodiscard]] double derivative(double spot) const noexcept override;
+    [[nodiscard]] double strike() const noexcept override { return m_strike; }
 
    private:
     double m_strike;
@@ -105,9 +135,32 @@ class PayoffAsianCall : public Payoff {
         return std::max(spot - m_strike, 0.0);
     }
     [[nodiscard]] std::string name() const override { return "Asian Call"; }
+    [[nodiscard]] double derivative(double spot) const noexcept override {
+        return spot > m_strike ? 1.0 : 0.0;
+    }
+    [[nodiscard]] double strike() const noexcept override { return m_strike; }
 
    private:
     double m_strike;
 };
 
+/**
+ * @brief Creates a payoff from its name() and strike().
+ *
+ * Used to rebuild a contract on the other side of a process boundary (sharding, caching).
+ * @param name Payoff name ("Call", "Put" or "Asian Call").
+ * @param strike Strike price.
+ * @throws std::invalid_argument If the name is unknown.
+ */
+[[nodiscard]] std::shared_ptr<Payoff> makePayoff(const std::string& name, double strike);
+
+/**
+ * @brief Whether the payoff is exactly one of the built-in types (not a subclass), i.e. fully
+ * described by its name() and strike().
+ *
+ * Features that identify a contract by these two values (the result cache) accept only such
+ * payoffs; a subclass may override operator() and still report its base's name and strike.
+ */
+[[nodiscard]] bool isBuiltinPayoff(const Payoff& payoff) noexcept;
+
 }  // namespace mcopt
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @file RandomStream.hpp
+ * @brief Адресуемые потоки случайных чисел.
+ *
+ * Каждый блок путей получает собственный генератор, зависящий только от (seed, домен, индекс),
+ * поэтому любой диапазон путей можно воспроизвести независимо — в другом потоке или процессе.
+ * Здесь же общее распределение блоков по потокам для всех движков.
+ */
+
+namespace mcopt {
+
+/// @brief Number of paths in one RNG block. Blocks are the unit of work distribution.
+inline constexpr unsigned long long PATHS_PER_BLOCK = 1ULL << 14;
+
+/// @brief RNG domain of the European/Asian path blocks.
+inline constexpr uint32_t STREAM_PATH_BLOCKS = 0;
+
+/// @brief RNG domain base of the MLMC levels (domain = STREAM_MLMC + level).
+inline constexpr uint32_t STREAM_MLMC = 0x100;
+
+/// @brief RNG domain base of the discrete-average MLMC levels (domain = base + level).
+inline constexpr uint32_t STREAM_MLMC_DISCRETE = 0x180;
+
+/// @brief RNG domain of the importance-sampling path blocks.
+inline constexpr uint32_t STREAM_IMPORTANCE = 0x200;
+
+/// @brief RNG domain of the strata of stratified sampling (index = stratum).
+inline constexpr uint32_t STREAM_STRATIFIED = 0x300;
+
+/// @brief RNG domain of the Neyman allocation pilot (index = stratum).
+inline constexpr uint32_t STREAM_STRATIFIED_PILOT = 0x301;
+
+/// @brief RNG domain of the Latin hypercube replicates (index = replicate).
+inline constexpr uint32_t STREAM_LATIN_HYPERCUBE = 0x400;
+
+/// @brief RNG domain of the local-volatility path blocks.
+inline constexpr uint32_t STREAM_LOCAL_VOL = 0x500;
+
+/// @brief RNG domain of the jump-diffusion path blocks.
+inline constexpr uint32_t STREAM_JUMP_DIFFUSION = 0x600;
+
+/// @brief RNG domain of the Heston path blocks.
+inline constexpr uint32_t STREAM_HESTON = 0x700;
+
+/**
+ * @brief Creates an independent generator addressed by (seed, domain, index).
+ *
+ * `std::seed_seq` mixes all components, so neighbouring indices give uncorrelated streams.
+ * The output of `std::mt19937_64` is fully specified by the standard.
+ */
+[[nodiscard]] inline std::mt19937_64 makeStreamRng(uint64_t seed, uint32_t domain, uint64_t index) {
+    std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), domain,
+                      static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32)};
+    return std::mt19937_64(seq);
+}
+
+/// @brief Number of blocks needed for numPaths paths.
+[[nodiscard]] constexpr unsigned long long blockCount(unsigned long long numPaths) noexcept {
+    return (numPaths + PATHS_PER_BLOCK - 1) / PATHS_PER_BLOCK;
+}
+
+/// @brief Number of paths in block `block` of a run with numPaths paths in total.
+[[nodiscard]] constexpr unsigned long long pathsInBlock(unsigned long long block,
+                                                        unsigned long long numPaths) noexcept {
+    unsigned long long begin = block * PATHS_PER_BLOCK;
+    if (begin >= numPaths) return 0;
+    unsigned long long end = begin + PATHS_PER_BLOCK;
+    return (end < numPaths ? end : numPaths) - begin;
+}
+
+/// @brief Thread count of a setNumThreads() argument: 0 means the hardware concurrency (>= 1).
+[[nodiscard]] inline unsigned int resolveThreadCount(unsigned int threads) noexcept {
+    if (threads > 0) return threads;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return (hw > 0) ? hw : 1;
+}
+
+/**
+ * @brief Splits blocks [0, numBlocks) into contiguous ranges, one per thread, and runs
+ * fn(begin, end) on each; returns when all ranges are done.
+ *
+ * At most numThreads threads (and no more than numBlocks) are started. Block streams do not
+ * depend on the thread that simulates them, so results do not depend on numThreads.
+ */
+template <typename Fn>
+void parallelForBlocks(unsigned long long numBlocks, unsigned int numThreads, Fn&& fn) {
+    if (numBlocks == 0) return;
+    const unsigned long long threads =
+        std::min<unsigned long long>(std::max(numThreads, 1U), numBlocks);
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(threads);
+    for (unsigned long long t = 0; t < threads; ++t) {
+        unsigned long long begin = numBlocks * t / threads;
+        unsigned long long end = numBlocks * (t + 1) / threads;
+        futures.push_back(std::async(std::launch::async, [&fn, begin, end]() { fn(begin, end); }));
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+}  // namespace mcopt
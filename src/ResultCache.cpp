@@ -0,0 +1,165 @@
+#include "ResultCache.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "RandomStream.hpp"
+#include "Serialization.hpp"
+
+namespace mcopt {
+
+unsigned long long CacheEntry::paths() const noexcept {
+    return completeBlocks * PATHS_PER_BLOCK + tailPaths;
+}
+
+PathStatistics CacheEntry::total() const noexcept {
+    PathStatistics stats = prefix;
+    stats.merge(tail);
+    return stats;
+}
+
+ResultCache::ResultCache(std::size_t capacity, std::string persistPath)
+    : m_capacity(capacity), m_persistPath(std::move(persistPath)) {
+    if (m_capacity == 0) {
+        throw std::invalid_argument("Cache capacity must be positive.");
+    }
+    if (!m_persistPath.empty()) {
+        load(m_persistPath);
+    }
+}
+
+ResultCache::~ResultCache() {
+    if (m_persistPath.empty()) return;
+    try {
+        save(m_persistPath);
+    } catch (...) {
+        // Деструктор не должен бросать исключения: кэш просто не сохранится
+    }
+}
+
+uint64_t ResultCache::hashKey(const std::string& key) noexcept {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::optional<CacheEntry> ResultCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto range = m_index.equal_range(hashKey(key));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->key == key) {
+            // Поднимаем запись в начало списка (most recently used)
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            ++m_hits;
+            return it->second->entry;
+        }
+    }
+    return std::nullopt;
+}
+
+void ResultCache::store(const std::string& key, const CacheEntry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    storeLocked(key, entry);
+}
+
+void ResultCache::storeLocked(const std::string& key, const CacheEntry& entry) {
+    uint64_t hash = hashKey(key);
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->key == key) {
+            it->second->entry = entry;
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return;
+        }
+    }
+
+    if (m_lru.size() >= m_capacity) {
+        // Вытесняем самую старую запись
+        const Node& oldest = m_lru.back();
+        auto victims = m_index.equal_range(hashKey(oldest.key));
+        for (auto it = victims.first; it != victims.second; ++it) {
+            if (it->second->key == oldest.key) {
+                m_index.erase(it);
+                break;
+            }
+        }
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front({key, entry});
+    m_index.emplace(hash, m_lru.begin());
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lru.clear();
+    m_index.clear();
+}
+
+std::size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lru.size();
+}
+
+std::size_t ResultCache::hits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+// Формат: одна запись на две строки — ключ, затем суммы в виде битовых образов
+void ResultCache::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open cache file " + path + " for writing.");
+    }
+    file << "MCCACHE 1 " << m_lru.size() << '\n';
+    for (auto it = m_lru.rbegin(); it != m_lru.rend(); ++it) {
+        const CacheEntry& e = it->entry;
+        file << it->key << '\n'
+             << e.completeBlocks << ' ' << doubleToBits(e.prefix.sum) << ' '
+             << doubleToBits(e.prefix.sumSq) << ' ' << e.prefix.count << ' ' << e.tailPaths << ' '
+             << doubleToBits(e.tail.sum) << ' ' << doubleToBits(e.tail.sumSq) << ' '
+             << e.tail.count << '\n';
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write cache file " + path);
+    }
+}
+
+void ResultCache::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+
+    std::string tag;
+    int version = 0;
+    std::size_t count = 0;
+    file >> tag >> version >> count >> std::ws;
+    if (tag != "MCCACHE" || version != 1) {
+        throw std::runtime_error("Unrecognised cache file " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string key;
+        std::getline(file, key);
+        CacheEntry e{};
+        file >> e.completeBlocks;
+        e.prefix.sum = readDoubleBits(file);
+        e.prefix.sumSq = readDoubleBits(file);
+        file >> e.prefix.count >> e.tailPaths;
+        e.tail.sum = readDoubleBits(file);
+        e.tail.sumSq = readDoubleBits(file);
+        file >> e.tail.count >> std::ws;
+        if (file.fail()) {
+            throw std::runtime_error("Malformed cache file " + path);
+        }
+        storeLocked(key, e);  // Старые записи идут первыми, порядок LRU сохраняется
+    }
+}
+
+}  // namespace mcopt
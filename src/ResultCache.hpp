@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "Statistics.hpp"
+
+/**
+ * @file ResultCache.hpp
+ * @brief Кэш накопленных сумм Монте-Карло с LRU-вытеснением.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct CacheEntry
+ * @brief Accumulated statistics of a run, split so that the run can be extended exactly.
+ *
+ * `prefix` is the block-order fold over all complete RNG blocks. The trailing partial block
+ * (if any) is kept separately: when more paths are requested it is recomputed in full and the
+ * fold continues from `prefix`, which reproduces a fresh run bit for bit.
+ */
+struct CacheEntry {
+    PathStatistics prefix;              ///< Fold over blocks [0, completeBlocks).
+    unsigned long long completeBlocks;  ///< Number of complete blocks in the prefix.
+    PathStatistics tail;                ///< Statistics of the trailing partial block.
+    unsigned long long tailPaths;       ///< Paths in the trailing partial block (0 if none).
+
+    /// @brief Total number of paths covered by the entry.
+    [[nodiscard]] unsigned long long paths() const noexcept;
+    /// @brief Statistics of the whole run (prefix followed by tail).
+    [[nodiscard]] PathStatistics total() const noexcept;
+};
+
+/**
+ * @class ResultCache
+ * @brief Thread-safe LRU cache of Monte Carlo statistics keyed by contract and market data.
+ *
+ * Keys are canonical descriptions built by the engine (payoff, spot, T, r, sigma, seed, steps,
+ * all doubles bit-exact); they are indexed by their 64-bit FNV-1a hash. The number of entries
+ * is bounded and every entry has a fixed size, so memory use is bounded too.
+ *
+ * With a persistence file the cache is loaded on construction and written back on
+ * destruction, so results survive between process runs.
+ */
+class ResultCache {
+   public:
+    /**
+     * @param capacity Maximum number of entries (least recently used ones are evicted).
+     * @param persistPath Optional file for on-disk persistence ("" = memory only).
+     * @throws std::invalid_argument If capacity is 0.
+     */
+    explicit ResultCache(std::size_t capacity = 1024, std::string persistPath = "");
+    ~ResultCache();
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /// @brief Looks up an entry and marks it as most recently used.
+    [[nodiscard]] std::optional<CacheEntry> find(const std::string& key);
+
+    /// @brief Inserts or replaces an entry, evicting the least recently used one if full.
+    void store(const std::string& key, const CacheEntry& entry);
+
+    /// @brief Removes all entries.
+    void clear();
+
+    /// @brief Current number of entries.
+    [[nodiscard]] std::size_t size() const;
+
+    /// @brief Number of find() calls that returned an entry since construction.
+    [[nodiscard]] std::size_t hits() const;
+
+    /// @brief Maximum number of entries.
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+    /**
+     * @brief Writes all entries to a text file (least recently used first).
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Loads entries from a file written by save(); a missing file is ignored.
+     * @throws std::runtime_error If the file is malformed.
+     */
+    void load(const std::string& path);
+
+    /// @brief 64-bit FNV-1a hash of a key.
+    [[nodiscard]] static uint64_t hashKey(const std::string& key) noexcept;
+
+   private:
+    struct Node {
+        std::string key;
+        CacheEntry entry;
+    };
+    using LruList = std::list<Node>;
+
+    void storeLocked(const std::string& key, const CacheEntry& entry);
+
+    std::size_t m_capacity;
+    std::string m_persistPath;
+    mutable std::mutex m_mutex;
+    LruList m_lru;  ///< Most recently used at the front.
+    std::size_t m_hits = 0;
+    std::unordered_multimap<uint64_t, LruList::iterator> m_index;
+};
+
+}  // namespace mcopt
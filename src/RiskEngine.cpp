@@ -0,0 +1,244 @@
+#include "RiskEngine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <typeinfo>
+
+#include "Analytical.hpp"
+#include "MCEngine.hpp"
+
+namespace mcopt {
+
+namespace {
+
+// Классификация позиции: ванильные идут в пакетную аналитику, остальные — в MC
+struct PositionInfo {
+    bool vanilla;
+    OptionType type;
+    bool asian;
+};
+
+// Тип сравнивается точно (как в ядрах MonteCarloEngine): наследник колла или пута со своей
+// выплатой переоценивается через MC, а не формулой Блэка-Шоулза. Азиатский признак
+// наследуется — он выбирает усреднение по траектории, а не формулу
+PositionInfo classify(const Payoff& payoff) {
+    if (typeid(payoff) == typeid(PayoffCall)) return {true, OptionType::Call, false};
+    if (typeid(payoff) == typeid(PayoffPut)) return {true, OptionType::Put, false};
+    bool asian = dynamic_cast<const PayoffAsianCall*>(&payoff) != nullptr;
+    return {false, OptionType::Call, asian};
+}
+
+MarketState shock(const MarketState& base, const MarketScenario& s) {
+    return {std::max(base.spot * (1.0 + s.spotShock), 0.0), base.rate + s.rateShock,
+            std::max(base.vol + s.volShock, 0.0)};
+}
+
+}  // namespace
+
+ScenarioEngine::ScenarioEngine(MarketState base, unsigned long long mcPaths,
+                               unsigned int asianSteps, uint64_t seed)
+    : m_base(base), m_mcPaths(mcPaths), m_asianSteps(asianSteps), m_seed(seed) {
+    if (m_base.spot < 0.0 || m_base.vol < 0.0) {
+        throw std::invalid_argument("Invalid base market (spot and vol must be >= 0).");
+    }
+    if (m_mcPaths == 0 || m_asianSteps == 0) {
+        throw std::invalid_argument("Monte Carlo paths and Asian steps must be positive.");
+    }
+    setNumThreads(0);
+}
+
+void ScenarioEngine::setNumThreads(unsigned int threads) {
+    if (threads == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        m_numThreads = (hw > 0) ? hw : 1;
+    } else {
+        m_numThreads = threads;
+    }
+}
+
+void ScenarioEngine::setTileSize(std::size_t scenarios, std::size_t positions) {
+    if (scenarios == 0 || positions == 0) {
+        throw std::invalid_argument("Tile dimensions must be positive.");
+    }
+    m_tileScenarios = scenarios;
+    m_tilePositions = positions;
+}
+
+std::vector<double> ScenarioEngine::portfolioValues(const std::vector<Position>& portfolio,
+                                                    const std::vector<MarketScenario>& scenarios,
+                                                    double horizon) const {
+    const std::size_t numScenarios = scenarios.size();
+    const std::size_t numPositions = portfolio.size();
+
+    std::vector<PositionInfo> info;
+    info.reserve(numPositions);
+    for (const auto& p : portfolio) {
+        if (!p.payoff) throw std::invalid_argument("Position payoff cannot be null.");
+        info.push_back(classify(*p.payoff));
+    }
+
+    const std::size_t scenarioTiles = (numScenarios + m_tileScenarios - 1) / m_tileScenarios;
+    const std::size_t positionTiles = (numPositions + m_tilePositions - 1) / m_tilePositions;
+    const std::size_t numTasks = scenarioTiles * positionTiles;
+
+    // Частичные суммы каждой плитки: [плитка][сценарий внутри плитки]
+    std::vector<std::vector<double>> partials(numTasks);
+
+    auto processTile = [&](std::size_t task) {
+        const std::size_t sBegin = (task / positionTiles) * m_tileScenarios;
+        const std::size_t sEnd = std::min(sBegin + m_tileScenarios, numScenarios);
+        const std::size_t pBegin = (task % positionTiles) * m_tilePositions;
+        const std::size_t pEnd = std::min(pBegin + m_tilePositions, numPositions);
+
+        std::vector<double>& values = partials[task];
+        values.assign(sEnd - sBegin, 0.0);
+
+        // Ванильные позиции плитки: один пакетный вызов аналитики (SoA)
+        std::vector<std::size_t> vanilla;
+        for (std::size_t p = pBegin; p < pEnd; ++p) {
+            if (info[p].vanilla) vanilla.push_back(p);
+        }
+        const std::size_t batch = (sEnd - sBegin) * vanilla.size();
+        if (batch > 0) {
+            std::vector<double> S(batch), K(batch), T(batch), r(batch), sigma(batch), out(batch);
+            std::vector<OptionType> type(batch);
+            std::size_t i = 0;
+            for (std::size_t s = sBegin; s < sEnd; ++s) {
+                MarketState m = shock(m_base, scenarios[s]);
+                for (std::size_t p : vanilla) {
+                    S[i] = m.spot;
+                    K[i] = portfolio[p].payoff->strike();
+                    T[i] = std::max(portfolio[p].maturity - horizon, 0.0);
+                    r[i] = m.rate;
+                    sigma[i] = m.vol;
+                    type[i] = info[p].type;
+                    ++i;
+                }
+            }
+            BlackScholesAnalytical::priceBatch(batch, S.data(), K.data(), T.data(), r.data(),
+                                               sigma.data(), type.data(), out.data());
+            i = 0;
+            for (std::size_t s = sBegin; s < sEnd; ++s) {
+                for (std::size_t p : vanilla) {
+                    values[s - sBegin] += portfolio[p].quantity * out[i++];
+                }
+            }
+        }
+
+        // Экзотика: Монте-Карло с общим seed во всех сценариях
+        for (std::size_t p = pBegin; p < pEnd; ++p) {
+            if (info[p].vanilla) continue;
+            double T = std::max(portfolio[p].maturity - horizon, 0.0);
+            for (std::size_t s = sBegin; s < sEnd; ++s) {
+                MarketState m = shock(m_base, scenarios[s]);
+                MonteCarloEngine engine(portfolio[p].payoff, m.spot, T, m.rate, m.vol, m_seed);
+                engine.setNumThreads(1);
+                double price = info[p].asian ? engine.calculateAsianPrice(m_mcPaths, m_asianSteps)
+                                             : engine.calculatePrice(m_mcPaths);
+                values[s - sBegin] += portfolio[p].quantity * price;
+            }
+        }
+    };
+
+    std::atomic<std::size_t> nextTask{0};
+    auto worker = [&]() {
+        for (std::size_t task = nextTask++; task < numTasks; task = nextTask++) {
+            processTile(task);
+        }
+    };
+
+    std::size_t numThreads = std::min<std::size_t>(m_numThreads, numTasks);
+    std::vector<std::future<void>> futures;
+    futures.reserve(numThreads);
+    for (std::size_t t = 0; t < numThreads; ++t) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+
+    // Сведение плиток в фиксированном порядке
+    std::vector<double> result(numScenarios, 0.0);
+    for (std::size_t task = 0; task < numTasks; ++task) {
+        const std::size_t sBegin = (task / positionTiles) * m_tileScenarios;
+        for (std::size_t j = 0; j < partials[task].size(); ++j) {
+            result[sBegin + j] += partials[task][j];
+        }
+    }
+    return result;
+}
+
+RiskReport ScenarioEngine::run(const std::vector<Position>& portfolio,
+                               const std::vector<MarketScenario>& scenarios, double confidence,
+                               double horizon) const {
+    if (scenarios.empty()) {
+        throw std::invalid_argument("At least one scenario is required.");
+    }
+    if (!(confidence > 0.0 && confidence < 1.0)) {
+        throw std::invalid_argument("Confidence level must be in (0, 1).");
+    }
+
+    RiskReport report{};
+    report.confidence = confidence;
+    report.baseValue = portfolioValues(portfolio, {{0.0, 0.0, 0.0}}, 0.0).front();
+    report.pnl = portfolioValues(portfolio, scenarios, horizon);
+    for (double& v : report.pnl) v -= report.baseValue;
+
+    // Убытки по возрастанию; VaR — квантиль, ES — среднее хвоста за ним
+    std::vector<double> losses(report.pnl.size());
+    std::transform(report.pnl.begin(), report.pnl.end(), losses.begin(),
+                   [](double x) { return -x; });
+    std::sort(losses.begin(), losses.end());
+
+    const double n = static_cast<double>(losses.size());
+    auto k = static_cast<std::size_t>(std::ceil(confidence * n));
+    k = std::min(std::max<std::size_t>(k, 1), losses.size()) - 1;
+
+    report.valueAtRisk = losses[k];
+    double tail = 0.0;
+    for (std::size_t i = k; i < losses.size(); ++i) tail += losses[i];
+    report.expectedShortfall = tail / static_cast<double>(losses.size() - k);
+    return report;
+}
+
+std::vector<MarketScenario> ScenarioEngine::historicalScenarios(
+    const std::vector<MarketState>& history) {
+    std::vector<MarketScenario> scenarios;
+    for (std::size_t i = 1; i < history.size(); ++i) {
+        const MarketState& prev = history[i - 1];
+        const MarketState& next = history[i];
+        if (prev.spot <= 0.0) {
+            throw std::invalid_argument("Historical spot observations must be positive.");
+        }
+        scenarios.push_back(
+            {next.spot / prev.spot - 1.0, next.vol - prev.vol, next.rate - prev.rate});
+    }
+    return scenarios;
+}
+
+std::vector<MarketScenario> ScenarioEngine::monteCarloScenarios(const MarketState& base,
+                                                                std::size_t count,
+                                                                double volOfVol, double rateVol,
+                                                                uint64_t seed, double horizon) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    const double sqrtH = std::sqrt(horizon);
+
+    std::vector<MarketScenario> scenarios;
+    scenarios.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        double z1 = dist(rng);
+        double z2 = dist(rng);
+        double z3 = dist(rng);
+        double logReturn = -0.5 * base.vol * base.vol * horizon + base.vol * sqrtH * z1;
+        scenarios.push_back({std::expm1(logReturn), volOfVol * sqrtH * z2, rateVol * sqrtH * z3});
+    }
+    return scenarios;
+}
+
+}  // namespace mcopt
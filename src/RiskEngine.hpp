@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Payoff.hpp"
+
+/**
+ * @file RiskEngine.hpp
+ * @brief Полная переоценка портфеля опционов по сценариям: распределение P&L, VaR и ES.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct Position
+ * @brief A position in a single option contract.
+ */
+struct Position {
+    std::shared_ptr<Payoff> payoff;  ///< Contract payoff (vanilla or path-dependent).
+    double quantity;                 ///< Number of contracts (negative for short positions).
+    double maturity;                 ///< Time to maturity in years.
+};
+
+/**
+ * @struct MarketState
+ * @brief Market data of the single underlying.
+ */
+struct MarketState {
+    double spot;  ///< Spot price.
+    double rate;  ///< Risk-free rate.
+    double vol;   ///< Volatility.
+};
+
+/**
+ * @struct MarketScenario
+ * @brief Shock applied to the base market state.
+ *
+ * Shocked state: \f$ S (1 + spotShock) \f$, \f$ \sigma + volShock \f$, \f$ r + rateShock \f$.
+ */
+struct MarketScenario {
+    double spotShock;  ///< Relative spot change (e.g. -0.05 for -5%).
+    double volShock;   ///< Absolute volatility change.
+    double rateShock;  ///< Absolute rate change.
+};
+
+/**
+ * @struct RiskReport
+ * @brief Result of a full-revaluation risk run.
+ *
+ * VaR and expected shortfall are reported as positive losses.
+ */
+struct RiskReport {
+    double baseValue;          ///< Portfolio value in the base market.
+    std::vector<double> pnl;   ///< P&L of each scenario, in scenario order.
+    double valueAtRisk;        ///< Loss quantile at the requested confidence.
+    double expectedShortfall;  ///< Mean loss beyond the VaR quantile.
+    double confidence;         ///< Confidence level (e.g. 0.99).
+};
+
+/**
+ * @class ScenarioEngine
+ * @brief Full-revaluation VaR / stress engine for a portfolio of options.
+ *
+ * Every position is repriced under every scenario:
+ * - Vanilla European calls/puts (exactly PayoffCall / PayoffPut) go through the batch path
+ *   `BlackScholesAnalytical::priceBatch()` (structure-of-arrays, one call per tile).
+ * - Other payoffs (Asian, subclasses overriding the payoff, etc.) are priced with
+ *   `MonteCarloEngine` using the same seed in every scenario (common random numbers), so the
+ *   P&L is not drowned in simulation noise.
+ *
+ * Work is split into tiles of scenarios \f$ \times \f$ positions that fit in cache; tiles are
+ * processed in parallel and their partial sums are reduced in a fixed order, so the result
+ * does not depend on the number of threads.
+ */
+class ScenarioEngine {
+   public:
+    /**
+     * @param base Base market state.
+     * @param mcPaths Paths per Monte Carlo revaluation of an exotic position.
+     * @param asianSteps Time steps for Asian positions.
+     * @param seed RNG seed shared by all Monte Carlo revaluations.
+     * @throws std::invalid_argument If the market state is invalid or mcPaths/asianSteps is 0.
+     */
+    explicit ScenarioEngine(MarketState base, unsigned long long mcPaths = 20'000,
+                            unsigned int asianSteps = 252, uint64_t seed = 42);
+
+    /// @brief Sets the number of worker threads (0 = hardware concurrency).
+    void setNumThreads(unsigned int threads);
+
+    /**
+     * @brief Sets the tile size.
+     * @param scenarios Scenarios per tile.
+     * @param positions Positions per tile.
+     * @throws std::invalid_argument If either is 0.
+     */
+    void setTileSize(std::size_t scenarios, std::size_t positions);
+
+    /**
+     * @brief Portfolio value under each scenario.
+     * @param horizon Time that elapses before the scenario is applied (maturities shrink by it).
+     */
+    [[nodiscard]] std::vector<double> portfolioValues(const std::vector<Position>& portfolio,
+                                                      const std::vector<MarketScenario>& scenarios,
+                                                      double horizon = 0.0) const;
+
+    /**
+     * @brief Runs the scenarios and computes the P&L distribution, VaR and ES.
+     * @param confidence VaR confidence level in (0, 1).
+     * @param horizon Risk horizon in years (default: one trading day).
+     * @throws std::invalid_argument If there are no scenarios or confidence is not in (0, 1).
+     */
+    [[nodiscard]] RiskReport run(const std::vector<Position>& portfolio,
+                                 const std::vector<MarketScenario>& scenarios,
+                                 double confidence = 0.99, double horizon = 1.0 / 252.0) const;
+
+    /**
+     * @brief Historical scenarios from a series of daily market observations.
+     *
+     * Scenario i applies the observed day-over-day change between observations i and i+1:
+     * relative for the spot, absolute for vol and rate.
+     */
+    [[nodiscard]] static std::vector<MarketScenario> historicalScenarios(
+        const std::vector<MarketState>& history);
+
+    /**
+     * @brief Monte Carlo scenarios with independent normal shocks over the horizon.
+     *
+     * The spot moves log-normally with the base volatility; vol and rate shocks are normal with
+     * the given annualised standard deviations, all scaled by \f$ \sqrt{horizon} \f$.
+     */
+    [[nodiscard]] static std::vector<MarketScenario> monteCarloScenarios(
+        const MarketState& base, std::size_t count, double volOfVol, double rateVol,
+        uint64_t seed, double horizon = 1.0 / 252.0);
+
+   private:
+    MarketState m_base;
+    unsigned long long m_mcPaths;
+    unsigned int m_asianSteps;
+    uint64_t m_seed;
+    unsigned int m_numThreads;
+    std::size_t m_tileScenarios = 64;
+    std::size_t m_tilePositions = 256;
+};
+
+}  // namespace mcopt
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+
+/**
+ * @file Serialization.hpp
+ * @brief Побитово точная текстовая запись чисел с плавающей точкой.
+ *
+ * Double записывается как целое с его битовым образом, поэтому значение восстанавливается
+ * без потерь на любой платформе с IEEE-754.
+ */
+
+namespace mcopt {
+
+/// @brief Bit pattern of a double.
+[[nodiscard]] inline uint64_t doubleToBits(double x) noexcept {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/// @brief Double with the given bit pattern.
+[[nodiscard]] inline double doubleFromBits(uint64_t bits) noexcept {
+    double x = 0.0;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/// @brief Reads a double written as its bit pattern.
+[[nodiscard]] inline double readDoubleBits(std::istream& in) {
+    uint64_t bits = 0;
+    in >> bits;
+    return doubleFromBits(bits);
+}
+
+}  // namespace mcopt
@@ -0,0 +1,364 @@
+#include "Sharding.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "Payoff.hpp"
+#include "RandomStream.hpp"
+#include "Serialization.hpp"
+
+#if MCOPT_HAS_SOCKETS
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace mcopt {
+
+MonteCarloEngine PricingJob::makeEngine() const {
+    return MonteCarloEngine(makePayoff(payoff, strike), S0, T, r, sigma, seed);
+}
+
+std::string serializeTask(const ShardTask& task) {
+    const PricingJob& job = task.job;
+    std::ostringstream out;
+    out << "TASK " << task.firstBlock << ' ' << task.lastBlock << ' ' << job.numSimulations << ' '
+        << job.numSteps << ' ' << job.seed << ' ' << doubleToBits(job.strike) << ' '
+        << doubleToBits(job.S0) << ' ' << doubleToBits(job.T) << ' ' << doubleToBits(job.r) << ' '
+        << doubleToBits(job.sigma) << ' ' << job.payoff << '\n';
+    return out.str();
+}
+
+ShardTask deserializeTask(const std::string& text) {
+    std::istringstream in(text);
+    std::string tag;
+    ShardTask task{};
+    PricingJob& job = task.job;
+    in >> tag >> task.firstBlock >> task.lastBlock >> job.numSimulations >> job.numSteps >>
+        job.seed;
+    job.strike = readDoubleBits(in);
+    job.S0 = readDoubleBits(in);
+    job.T = readDoubleBits(in);
+    job.r = readDoubleBits(in);
+    job.sigma = readDoubleBits(in);
+    in >> std::ws;
+    std::getline(in, job.payoff);  // Имя может содержать пробелы ("Asian Call")
+    if (tag != "TASK" || in.fail() || job.payoff.empty()) {
+        throw std::runtime_error("Malformed shard task.");
+    }
+    // Диапазон должен быть непустым и лежать внутри блоков задания
+    if (task.firstBlock >= task.lastBlock || task.lastBlock > blockCount(job.numSimulations)) {
+        throw std::invalid_argument("Shard block range [" + std::to_string(task.firstBlock) +
+                                    ", " + std::to_string(task.lastBlock) +
+                                    ") is empty or outside the job's " +
+                                    std::to_string(blockCount(job.numSimulations)) + " blocks.");
+    }
+    return task;
+}
+
+std::string serializeResult(const ShardResult& result) {
+    std::ostringstream out;
+    out << "RESULT " << result.firstBlock << ' ' << result.blocks.size();
+    for (const auto& b : result.blocks) {
+        out << ' ' << doubleToBits(b.sum) << ' ' << doubleToBits(b.sumSq) << ' ' << b.count;
+    }
+    out << '\n';
+    return out.str();
+}
+
+ShardResult deserializeResult(const std::string& text) {
+    std::istringstream in(text);
+    std::string tag;
+    in >> tag;
+    if (tag == "ERROR") {
+        std::string message;
+        std::getline(in >> std::ws, message);
+        throw std::runtime_error("Shard worker failed: " + message);
+    }
+
+    ShardResult result{};
+    std::size_t n = 0;
+    in >> result.firstBlock >> n;
+    if (tag != "RESULT" || in.fail()) {
+        throw std::runtime_error("Malformed shard result.");
+    }
+    result.blocks.resize(n);
+    for (auto& b : result.blocks) {
+        b.sum = readDoubleBits(in);
+        b.sumSq = readDoubleBits(in);
+        in >> b.count;
+    }
+    if (in.fail()) {
+        throw std::runtime_error("Truncated shard result.");
+    }
+    return result;
+}
+
+ShardResult runShard(const ShardTask& task, unsigned int numThreads) {
+    MonteCarloEngine engine = task.job.makeEngine();
+    engine.setNumThreads(numThreads);
+    return {task.firstBlock, engine.simulateBlocks(task.firstBlock, task.lastBlock,
+                                                   task.job.numSimulations, task.job.numSteps)};
+}
+
+std::size_t LocalTransport::concurrency() const noexcept {
+    unsigned int hw = std::thread::hardware_concurrency();
+    unsigned int perShard = std::max(m_threadsPerShard, 1U);
+    return std::max<std::size_t>((hw > 0 ? hw : 1) / perShard, 1);
+}
+
+std::future<ShardResult> LocalTransport::submit(const ShardTask& task) {
+    std::string request = serializeTask(task);
+    unsigned int threads = m_threadsPerShard;
+    return std::async(std::launch::async, [request, threads]() {
+        return deserializeResult(serializeResult(runShard(deserializeTask(request), threads)));
+    });
+}
+
+// ==========================================
+// TCP транспорт (POSIX)
+// ==========================================
+
+#if MCOPT_HAS_SOCKETS
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // Без SIGPIPE при обрыве соединения
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+static void sendAll(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+        if (n <= 0) throw std::runtime_error("Socket send failed.");
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+// Чтение до EOF; больше maxBytes — ошибка соединения, а не рост буфера без предела
+static std::string receiveAll(int fd, std::size_t maxBytes = std::string::npos) {
+    std::string data;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0) {
+            bool timedOut = errno == EAGAIN || errno == EWOULDBLOCK;
+            throw std::runtime_error(timedOut ? "Socket receive timed out."
+                                              : "Socket receive failed.");
+        }
+        if (n == 0) break;
+        if (static_cast<std::size_t>(n) > maxBytes - data.size()) {
+            throw std::runtime_error("Request exceeds " + std::to_string(maxBytes) + " bytes.");
+        }
+        data.append(buffer, static_cast<std::size_t>(n));
+    }
+    return data;
+}
+
+static int connectTo(const WorkerEndpoint& endpoint) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* list = nullptr;
+    std::string port = std::to_string(endpoint.port);
+    if (::getaddrinfo(endpoint.host.c_str(), port.c_str(), &hints, &list) != 0) {
+        throw std::runtime_error("Cannot resolve worker " + endpoint.host);
+    }
+    int fd = -1;
+    for (addrinfo* a = list; a != nullptr; a = a->ai_next) {
+        fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    ::freeaddrinfo(list);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot connect to worker " + endpoint.host + ":" + port);
+    }
+    return fd;
+}
+
+SocketTransport::SocketTransport(std::vector<WorkerEndpoint> workers)
+    : m_workers(std::move(workers)) {
+    if (m_workers.empty()) {
+        throw std::invalid_argument("SocketTransport needs at least one worker.");
+    }
+}
+
+std::future<ShardResult> SocketTransport::submit(const ShardTask& task) {
+    WorkerEndpoint endpoint = m_workers[m_next++ % m_workers.size()];
+    std::string request = serializeTask(task);
+    return std::async(std::launch::async, [endpoint, request]() {
+        int fd = connectTo(endpoint);
+        std::string response;
+        try {
+            sendAll(fd, request);
+            ::shutdown(fd, SHUT_WR);
+            response = receiveAll(fd);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        return deserializeResult(response);
+    });
+}
+
+ShardWorkerServer::ShardWorkerServer(uint16_t port, unsigned int numThreads,
+                                     const std::string& bindAddress)
+    : m_numThreads(numThreads) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1) {
+        throw std::invalid_argument("Invalid worker bind address: " + bindAddress);
+    }
+
+    m_socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0) throw std::runtime_error("Cannot create worker socket.");
+
+    int reuse = 1;
+    ::setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    socklen_t len = sizeof(addr);
+    if (::bind(m_socket, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+        ::listen(m_socket, SOMAXCONN) != 0 ||
+        ::getsockname(m_socket, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        ::close(m_socket);
+        throw std::runtime_error("Cannot bind worker socket to " + bindAddress + ":" +
+                                 std::to_string(port));
+    }
+    m_port = ntohs(addr.sin_port);
+}
+
+ShardWorkerServer::~ShardWorkerServer() {
+    if (m_socket >= 0) ::close(m_socket);
+}
+
+void ShardWorkerServer::setReceiveTimeout(std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0) {
+        throw std::invalid_argument("Receive timeout must be positive.");
+    }
+    m_receiveTimeout = timeout;
+}
+
+void ShardWorkerServer::serve(std::size_t maxTasks) {
+    for (std::size_t served = 0; maxTasks == 0 || served < maxTasks; ++served) {
+        int client = ::accept(m_socket, nullptr, nullptr);
+        if (client < 0) throw std::runtime_error("Worker accept failed.");
+
+        // Зависший клиент не держит воркер дольше таймаута
+        timeval timeout{};
+        timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(m_receiveTimeout.count() / 1000);
+        timeout.tv_usec =
+            static_cast<decltype(timeout.tv_usec)>(m_receiveTimeout.count() % 1000 * 1000);
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string response;
+        try {
+            std::string request = receiveAll(client, MAX_TASK_BYTES);
+            response = serializeResult(runShard(deserializeTask(request), m_numThreads));
+        } catch (const std::exception& e) {
+            response = std::string("ERROR ") + e.what() + "\n";
+        }
+        try {
+            sendAll(client, response);
+        } catch (const std::exception&) {
+            // Координатор отключился — переходим к следующему соединению
+        }
+        ::close(client);
+    }
+}
+
+#else
+
+SocketTransport::SocketTransport(std::vector<WorkerEndpoint> workers)
+    : m_workers(std::move(workers)) {
+    throw std::runtime_error("SocketTransport is not supported on this platform.");
+}
+
+std::future<ShardResult> SocketTransport::submit(const ShardTask&) {
+    throw std::runtime_error("SocketTransport is not supported on this platform.");
+}
+
+ShardWorkerServer::ShardWorkerServer(uint16_t, unsigned int numThreads, const std::string&)
+    : m_numThreads(numThreads) {
+    throw std::runtime_error("ShardWorkerServer is not supported on this platform.");
+}
+
+ShardWorkerServer::~ShardWorkerServer() = default;
+
+void ShardWorkerServer::setReceiveTimeout(std::chrono::milliseconds timeout) {
+    m_receiveTimeout = timeout;
+}
+
+void ShardWorkerServer::serve(std::size_t) {}
+
+#endif
+
+// ==========================================
+// Координатор
+// ==========================================
+
+ShardCoordinator::ShardCoordinator(std::shared_ptr<ShardTransport> transport,
+                                   unsigned long long blocksPerShard)
+    : m_transport(std::move(transport)), m_blocksPerShard(blocksPerShard) {
+    if (!m_transport) {
+        throw std::invalid_argument("Shard transport cannot be null.");
+    }
+    if (m_blocksPerShard == 0) {
+        throw std::invalid_argument("Shard size must be at least one block.");
+    }
+}
+
+std::vector<ShardTask> ShardCoordinator::split(const PricingJob& job) const {
+    std::vector<ShardTask> tasks;
+    unsigned long long numBlocks = blockCount(job.numSimulations);
+    for (unsigned long long first = 0; first < numBlocks; first += m_blocksPerShard) {
+        unsigned long long last = std::min(first + m_blocksPerShard, numBlocks);
+        tasks.push_back({job, first, last});
+    }
+    return tasks;
+}
+
+PricingResult ShardCoordinator::price(const PricingJob& job) const {
+    // Валидация параметров до рассылки задач
+    MonteCarloEngine engine = job.makeEngine();
+
+    std::vector<ShardTask> tasks = split(job);
+    std::vector<std::future<ShardResult>> futures(tasks.size());
+    const std::size_t window =
+        SHARDS_IN_FLIGHT_PER_SLOT * std::max<std::size_t>(m_transport->concurrency(), 1);
+
+    // Сборка блоков в исходном порядке; новый шард уходит, как только забран самый старый
+    std::vector<PathStatistics> blocks(blockCount(job.numSimulations));
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        for (; submitted < tasks.size() && submitted - i < window; ++submitted) {
+            futures[submitted] = m_transport->submit(tasks[submitted]);
+        }
+        ShardResult result = futures[i].get();
+        const ShardTask& task = tasks[i];
+        if (result.firstBlock != task.firstBlock ||
+            result.blocks.size() != task.lastBlock - task.firstBlock) {
+            throw std::runtime_error("Shard result does not match the requested block range.");
+        }
+        std::copy(result.blocks.begin(), result.blocks.end(),
+                  blocks.begin() + static_cast<std::ptrdiff_t>(task.firstBlock));
+    }
+
+    PathStatistics total = reduceBlocks(blocks);
+    double discount = engine.discountFactor();
+    return {discount * total.mean(), discount * total.standardError(), job.numSimulations};
+}
+
+}  // namespace mcopt
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MCEngine.hpp"
+#include "Statistics.hpp"
+
+/**
+ * @file Sharding.hpp
+ * @brief Детерминированное распределение симуляции по процессам и узлам.
+ *
+ * Задача делится на диапазоны RNG-блоков (шарды). Воркеры считают частичные суммы по блокам,
+ * координатор сводит их в порядке блоков — результат побитово совпадает с однопроцессным.
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MCOPT_HAS_SOCKETS 1
+#else
+#define MCOPT_HAS_SOCKETS 0
+#endif
+
+namespace mcopt {
+
+/**
+ * @struct PricingJob
+ * @brief Self-contained, serializable description of a pricing run.
+ */
+struct PricingJob {
+    std::string payoff;                 ///< Payoff name, see makePayoff().
+    double strike;                      ///< Strike price.
+    double S0;                          ///< Initial spot price.
+    double T;                           ///< Time to maturity (years).
+    double r;                           ///< Risk-free rate.
+    double sigma;                       ///< Volatility.
+    uint64_t seed;                      ///< Master RNG seed.
+    unsigned long long numSimulations;  ///< Total number of paths.
+    unsigned int numSteps;              ///< 0 for European, otherwise Asian time steps.
+
+    /// @brief Builds the engine described by this job.
+    [[nodiscard]] MonteCarloEngine makeEngine() const;
+};
+
+/**
+ * @struct ShardTask
+ * @brief A half-open range of RNG blocks [firstBlock, lastBlock) of a job.
+ */
+struct ShardTask {
+    PricingJob job;                 ///< The job this shard belongs to.
+    unsigned long long firstBlock;  ///< First block of the shard.
+    unsigned long long lastBlock;   ///< One past the last block of the shard.
+};
+
+/**
+ * @struct ShardResult
+ * @brief Per-block partial sums computed by a worker.
+ */
+struct ShardResult {
+    unsigned long long firstBlock;       ///< Index of blocks[0].
+    std::vector<PathStatistics> blocks;  ///< Statistics of each block, in block order.
+};
+
+/// @brief Encodes a task as a single text line (doubles are sent bit-exact).
+[[nodiscard]] std::string serializeTask(const ShardTask& task);
+/**
+ * @brief Decodes a task.
+ * @throws std::runtime_error On malformed input.
+ * @throws std::invalid_argument If the block range is empty or exceeds
+ * `blockCount(job.numSimulations)`.
+ */
+[[nodiscard]] ShardTask deserializeTask(const std::string& text);
+/// @brief Encodes a result as a single text line (doubles are sent bit-exact).
+[[nodiscard]] std::string serializeResult(const ShardResult& result);
+/// @brief Decodes a result. @throws std::runtime_error On malformed input or a worker error.
+[[nodiscard]] ShardResult deserializeResult(const std::string& text);
+
+/**
+ * @brief Worker entry point: simulates the blocks of one shard.
+ * @param task The shard to compute.
+ * @param numThreads Threads used inside the worker (0 = hardware concurrency).
+ */
+[[nodiscard]] ShardResult runShard(const ShardTask& task, unsigned int numThreads = 0);
+
+/**
+ * @class ShardTransport
+ * @brief Pluggable channel between the coordinator and its workers.
+ */
+class ShardTransport {
+   public:
+    ShardTransport() = default;
+    virtual ~ShardTransport() = default;
+    ShardTransport(const ShardTransport&) = delete;
+    ShardTransport& operator=(const ShardTransport&) = delete;
+
+    /**
+     * @brief Sends a shard to a worker.
+     * @return Future that yields the worker's per-block statistics.
+     */
+    [[nodiscard]] virtual std::future<ShardResult> submit(const ShardTask& task) = 0;
+
+    /**
+     * @brief Number of shards the transport computes at once (worker processes or thread
+     * slots); the coordinator keeps a small multiple of it in flight.
+     */
+    [[nodiscard]] virtual std::size_t concurrency() const noexcept { return 1; }
+};
+
+/**
+ * @class LocalTransport
+ * @brief In-process transport: each shard runs on its own thread.
+ *
+ * Tasks and results still go through the text codec, so it exercises the same path as a
+ * remote transport.
+ */
+class LocalTransport : public ShardTransport {
+   public:
+    /// @param threadsPerShard Threads used by each shard.
+    explicit LocalTransport(unsigned int threadsPerShard = 1)
+        : m_threadsPerShard(threadsPerShard) {}
+
+    [[nodiscard]] std::future<ShardResult> submit(const ShardTask& task) override;
+
+    /// @brief Hardware threads divided by the threads per shard (at least 1).
+    [[nodiscard]] std::size_t concurrency() const noexcept override;
+
+   private:
+    unsigned int m_threadsPerShard;
+};
+
+/**
+ * @struct WorkerEndpoint
+ * @brief Network address of a shard worker.
+ */
+struct WorkerEndpoint {
+    std::string host;  ///< Host name or IP address.
+    uint16_t port;     ///< TCP port.
+};
+
+/**
+ * @class SocketTransport
+ * @brief TCP transport: shards are sent round-robin to worker processes (see ShardWorkerServer).
+ *
+ * One connection per shard: the task line is sent, the write side is closed and the result
+ * line is read until EOF. Available on POSIX systems only.
+ */
+class SocketTransport : public ShardTransport {
+   public:
+    /// @throws std::invalid_argument If no endpoints are given.
+    explicit SocketTransport(std::vector<WorkerEndpoint> workers);
+
+    /// @throws std::runtime_error (from the future) On connection or worker errors.
+    [[nodiscard]] std::future<ShardResult> submit(const ShardTask& task) override;
+
+    /// @brief Number of worker endpoints.
+    [[nodiscard]] std::size_t concurrency() const noexcept override { return m_workers.size(); }
+
+   private:
+    std::vector<WorkerEndpoint> m_workers;
+    std::atomic<std::size_t> m_next{0};
+};
+
+/**
+ * @class ShardWorkerServer
+ * @brief TCP server that computes shards for a SocketTransport.
+ */
+class ShardWorkerServer {
+   public:
+    /**
+     * @brief Binds and listens on `bindAddress`.
+     *
+     * The protocol has no authentication and the server runs every job it receives, so the
+     * default is loopback only; bind to another interface ("0.0.0.0" for all) only on a trusted
+     * network.
+     * @param port TCP port; 0 picks a free port (see port()).
+     * @param numThreads Threads used per shard (0 = hardware concurrency).
+     * @param bindAddress IPv4 address of the interface to listen on.
+     * @throws std::invalid_argument If bindAddress is not an IPv4 address.
+     * @throws std::runtime_error If the socket cannot be created or bound.
+     */
+    explicit ShardWorkerServer(uint16_t port = 0, unsigned int numThreads = 0,
+                               const std::string& bindAddress = "127.0.0.1");
+    ~ShardWorkerServer();
+    ShardWorkerServer(const ShardWorkerServer&) = delete;
+    ShardWorkerServer& operator=(const ShardWorkerServer&) = delete;
+
+    /// @brief The port the server listens on.
+    [[nodiscard]] uint16_t port() const noexcept { return m_port; }
+
+    /**
+     * @brief Longest wait for the next bytes of a request (default 30 s).
+     *
+     * Connections are served one at a time, so a client that stalls before closing its write
+     * side would otherwise block the worker.
+     * @throws std::invalid_argument If the timeout is not positive.
+     */
+    void setReceiveTimeout(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Serves connections one after another.
+     *
+     * A request larger than MAX_TASK_BYTES or not completed within the receive timeout fails
+     * its connection with an error reply; the worker then moves on to the next connection.
+     * @param maxTasks Stop after this many connections (0 = serve forever).
+     */
+    void serve(std::size_t maxTasks = 0);
+
+   private:
+    int m_socket = -1;
+    uint16_t m_port = 0;
+    unsigned int m_numThreads;
+    std::chrono::milliseconds m_receiveTimeout{30'000};
+};
+
+/// @brief Largest task request a worker accepts; a task line is well under 1 KB.
+inline constexpr std::size_t MAX_TASK_BYTES = 4096;
+
+/// @brief Outstanding shards per transport slot: one computing, one queued behind it.
+inline constexpr std::size_t SHARDS_IN_FLIGHT_PER_SLOT = 2;
+
+/**
+ * @class ShardCoordinator
+ * @brief Splits a job into block ranges, dispatches them and merges the partial sums.
+ *
+ * Block statistics are reassembled in block order and reduced with reduceBlocks(), so the
+ * price is bit-for-bit identical to `MonteCarloEngine::calculatePrice()` (or
+ * `calculateAsianPrice()`) of the same job in a single process.
+ *
+ * At most SHARDS_IN_FLIGHT_PER_SLOT x `transport.concurrency()` shards are outstanding at a
+ * time: a job of ~10^4 shards does not open ~10^4 connections and threads at once. The next
+ * shard is submitted as soon as the oldest outstanding one has been collected.
+ */
+class ShardCoordinator {
+   public:
+    /**
+     * @param transport Channel to the workers.
+     * @param blocksPerShard Shard size in RNG blocks (each block has PATHS_PER_BLOCK paths).
+     * @throws std::invalid_argument If transport is null or blocksPerShard is 0.
+     */
+    explicit ShardCoordinator(std::shared_ptr<ShardTransport> transport,
+                              unsigned long long blocksPerShard = 64);
+
+    /// @brief Shard ranges of a job, in block order.
+    [[nodiscard]] std::vector<ShardTask> split(const PricingJob& job) const;
+
+    /**
+     * @brief Prices a job on the workers.
+     * @throws std::runtime_error If a worker fails or returns an inconsistent range.
+     */
+    [[nodiscard]] PricingResult price(const PricingJob& job) const;
+
+   private:
+    std::shared_ptr<ShardTransport> m_transport;
+    unsigned long long m_blocksPerShard;
+};
+
+}  // namespace mcopt
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+/**
+ * @file Statistics.hpp
+ * @brief Накопление выборочных сумм и оценка стандартной ошибки.
+ */
+
+namespace mcopt {
+
+/**
+ * @struct PathStatistics
+ * @brief Running sums of Monte Carlo samples.
+ *
+ * A *sample* is one independent draw of the estimator: the mean of an antithetic pair
+ * \f$ (f(Z) + f(-Z)) / 2 \f$ for European pricing or a single path for Asian pricing.
+ * Partial statistics from blocks, threads or processes are combined with merge().
+ */
+struct PathStatistics {
+    double sum = 0.0;              ///< \f$ \sum_i y_i \f$ (undiscounted).
+    double sumSq = 0.0;            ///< \f$ \sum_i y_i^2 \f$.
+    unsigned long long count = 0;  ///< Number of samples.
+
+    /// @brief Adds a single sample.
+    void add(double y) noexcept {
+        sum += y;
+        sumSq += y * y;
+        ++count;
+    }
+
+    /// @brief Accumulates another partial result.
+    void merge(const PathStatistics& other) noexcept {
+        sum += other.sum;
+        sumSq += other.sumSq;
+        count += other.count;
+    }
+
+    /// @brief Sample mean (0 if empty).
+    [[nodiscard]] double mean() const noexcept {
+        return count > 0 ? sum / static_cast<double>(count) : 0.0;
+    }
+
+    /// @brief Unbiased sample variance (0 if fewer than two samples).
+    [[nodiscard]] double variance() const noexcept {
+        if (count < 2) return 0.0;
+        double n = static_cast<double>(count);
+        double m = sum / n;
+        double v = (sumSq - n * m * m) / (n - 1.0);
+        return v > 0.0 ? v : 0.0;
+    }
+
+    /// @brief Standard error of the mean \f$ \sqrt{s^2 / n} \f$.
+    [[nodiscard]] double standardError() const noexcept {
+        return count > 0 ? std::sqrt(variance() / static_cast<double>(count)) : 0.0;
+    }
+};
+
+/**
+ * @struct CompensatedSum
+ * @brief Neumaier (improved Kahan) summation: keeps the rounding error of every addition.
+ */
+struct CompensatedSum {
+    double sum = 0.0;           ///< Running sum.
+    double compensation = 0.0;  ///< Accumulated low-order bits lost by `sum`.
+
+    /// @brief Adds a value with error compensation.
+    void add(double x) noexcept {
+        double t = sum + x;
+        if (std::abs(sum) >= std::abs(x)) {
+            compensation += (sum - t) + x;
+        } else {
+            compensation += (x - t) + sum;
+        }
+        sum = t;
+    }
+
+    /// @brief Compensated total.
+    [[nodiscard]] double value() const noexcept { return sum + compensation; }
+};
+
+/**
+ * @class BlockAccumulator
+ * @brief Two-level reduction of the samples of one RNG block.
+ *
+ * Samples are summed in double within small batches; batch sums are then added with
+ * compensated summation. Used by the simulation kernels so that neither single-precision
+ * paths nor large path counts lose accuracy in the reduction.
+ */
+class BlockAccumulator {
+   public:
+    /// @brief Adds the double-precision sums of one batch of n samples.
+    void addBatch(double batchSum, double batchSumSq, unsigned long long n) noexcept {
+        m_sum.add(batchSum);
+        m_sumSq.add(batchSumSq);
+        m_count += n;
+    }
+
+    /// @brief Statistics of all batches added so far.
+    [[nodiscard]] PathStatistics result() const noexcept {
+        return {m_sum.value(), m_sumSq.value(), m_count};
+    }
+
+   private:
+    CompensatedSum m_sum;
+    CompensatedSum m_sumSq;
+    unsigned long long m_count = 0;
+};
+
+/**
+ * @brief Canonical reduction of per-block statistics: a sequential fold in block order.
+ *
+ * Every execution mode (threads, processes, nodes) reduces blocks in this order, so the
+ * result is bit-for-bit identical however the blocks were distributed.
+ */
+[[nodiscard]] inline PathStatistics reduceBlocks(const std::vector<PathStatistics>& blocks) {
+    PathStatistics total;
+    for (const auto& b : blocks) total.merge(b);
+    return total;
+}
+
+/**
+ * @struct PricingResult
+ * @brief Discounted price together with its Monte Carlo error estimate.
+ */
+struct PricingResult {
+    double price;              ///< Discounted mean payoff.
+    double standardError;      ///< Discounted standard error of the price.
+    unsigned long long paths;  ///< Number of simulated paths.
+};
+
+}  // namespace mcopt
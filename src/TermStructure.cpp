@@ -0,0 +1,65 @@
+#include "TermStructure.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace mcopt {
+
+PiecewiseConstantCurve::PiecewiseConstantCurve(double value) : m_values{value} {}
+
+PiecewiseConstantCurve::PiecewiseConstantCurve(std::vector<double> knots,
+                                               std::vector<double> values)
+    : m_knots(std::move(knots)), m_values(std::move(values)) {
+    if (m_values.size() != m_knots.size() + 1) {
+        throw std::invalid_argument("Curve needs exactly one value per interval (knots + 1).");
+    }
+    for (std::size_t i = 0; i < m_knots.size(); ++i) {
+        if (!(m_knots[i] > 0.0) || (i > 0 && !(m_knots[i] > m_knots[i - 1]))) {
+            throw std::invalid_argument("Curve knots must be positive and strictly increasing.");
+        }
+    }
+}
+
+std::size_t PiecewiseConstantCurve::intervalAfter(double t) const noexcept {
+    return static_cast<std::size_t>(std::upper_bound(m_knots.begin(), m_knots.end(), t) -
+                                    m_knots.begin());
+}
+
+double PiecewiseConstantCurve::value(double t) const noexcept {
+    // Узел принадлежит левому интервалу: (t_k, t_{k+1}]
+    auto k = static_cast<std::size_t>(std::lower_bound(m_knots.begin(), m_knots.end(), t) -
+                                      m_knots.begin());
+    return m_values[k];
+}
+
+template <typename F>
+double PiecewiseConstantCurve::integrate(double a, double b, F transform) const noexcept {
+    if (!(b > a)) return 0.0;
+    double total = 0.0;
+    double left = a;
+    for (std::size_t k = intervalAfter(a); k < m_values.size(); ++k) {
+        double right = (k < m_knots.size()) ? std::min(m_knots[k], b) : b;
+        total += transform(m_values[k]) * (right - left);
+        if (right >= b) break;
+        left = right;
+    }
+    return total;
+}
+
+double PiecewiseConstantCurve::integral(double a, double b) const noexcept {
+    return integrate(a, b, [](double v) { return v; });
+}
+
+double PiecewiseConstantCurve::squareIntegral(double a, double b) const noexcept {
+    return integrate(a, b, [](double v) { return v * v; });
+}
+
+bool PiecewiseConstantCurve::constantOn(double a, double b, double& value) const noexcept {
+    std::size_t k = intervalAfter(a);
+    if (k < m_knots.size() && b > m_knots[k]) return false;
+    value = m_values[k];
+    return true;
+}
+
+}  // namespace mcopt
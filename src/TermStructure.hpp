@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file TermStructure.hpp
+ * @brief Кусочно-постоянные кривые ставки и волатильности, дискретные дивиденды.
+ */
+
+namespace mcopt {
+
+/**
+ * @class PiecewiseConstantCurve
+ * @brief Piecewise-constant function of time (short rate or instantaneous volatility).
+ *
+ * With knots \f$ t_1 < \dots < t_m \f$ and values \f$ v_0, \dots, v_m \f$ the curve equals
+ * \f$ v_0 \f$ on \f$ [0, t_1] \f$, \f$ v_k \f$ on \f$ (t_k, t_{k+1}] \f$ and \f$ v_m \f$
+ * after \f$ t_m \f$.
+ */
+class PiecewiseConstantCurve {
+   public:
+    /// @brief Flat curve.
+    explicit PiecewiseConstantCurve(double value);
+
+    /**
+     * @param knots Strictly increasing positive times \f$ t_1, \dots, t_m \f$.
+     * @param values m + 1 values, one per interval.
+     * @throws std::invalid_argument If the sizes do not match or the knots are not increasing.
+     */
+    PiecewiseConstantCurve(std::vector<double> knots, std::vector<double> values);
+
+    /// @brief Value at time t (right-continuous at the knots from the left interval).
+    [[nodiscard]] double value(double t) const noexcept;
+    /// @brief \f$ \int_a^b v(t)\,dt \f$.
+    [[nodiscard]] double integral(double a, double b) const noexcept;
+    /// @brief \f$ \int_a^b v(t)^2\,dt \f$ (integrated variance for a vol curve).
+    [[nodiscard]] double squareIntegral(double a, double b) const noexcept;
+
+    /**
+     * @brief True if the curve is constant on [a, b]; the constant is written to `value`.
+     *
+     * Steps inside one interval are then evaluated exactly like the constant-parameter model.
+     */
+    [[nodiscard]] bool constantOn(double a, double b, double& value) const noexcept;
+
+    /// @brief True for a single-interval (flat) curve.
+    [[nodiscard]] bool isFlat() const noexcept { return m_knots.empty(); }
+    /// @brief Interior knots.
+    [[nodiscard]] const std::vector<double>& knots() const noexcept { return m_knots; }
+    /// @brief Values, one per interval.
+    [[nodiscard]] const std::vector<double>& values() const noexcept { return m_values; }
+
+   private:
+    /// @brief Index of the interval containing (t, t + eps).
+    [[nodiscard]] std::size_t intervalAfter(double t) const noexcept;
+
+    template <typename F>
+    [[nodiscard]] double integrate(double a, double b, F transform) const noexcept;
+
+    std::vector<double> m_knots;
+    std::vector<double> m_values;
+};
+
+/// @brief Kind of a discrete dividend.
+enum class DividendType {
+    Cash,         ///< Fixed amount paid at the ex-date.
+    Proportional  ///< Fraction of the spot paid at the ex-date.
+};
+
+/**
+ * @struct Dividend
+ * @brief A discrete dividend with its ex-date.
+ */
+struct Dividend {
+    double time;        ///< Ex-dividend time in years.
+    double amount;      ///< Cash amount, or the fraction in [0, 1) for a proportional dividend.
+    DividendType type;  ///< Cash or proportional.
+};
+
+}  // namespace mcopt
@@ -0,0 +1,172 @@
+#include "VariateBank.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "RandomStream.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mcopt {
+
+namespace {
+
+constexpr char BANK_MAGIC[8] = {'M', 'C', 'V', 'B', 'A', 'N', 'K', '\0'};
+constexpr uint32_t BANK_VERSION = 1;
+
+// Заголовок занимает 64 байта: данные выровнены по строке кэша
+struct BankHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t method;
+    uint64_t seed;
+    uint64_t blocks;
+    uint64_t variatesPerBlock;
+    char reserved[24];
+};
+static_assert(sizeof(BankHeader) == 64, "Bank header must be 64 bytes.");
+
+}  // namespace
+
+void VariateBank::create(const std::string& path, uint64_t seed, NormalMethod method,
+                         unsigned long long numPaths, unsigned int numSteps) {
+    if (numPaths == 0) {
+        throw std::invalid_argument("Variate bank needs at least one path.");
+    }
+    // Европейское ядро берет одну нормаль на пару (и одну на непарный путь), азиатское —
+    // одну на путь и шаг
+    const std::size_t perBlock = (numSteps == 0)
+                                     ? static_cast<std::size_t>((PATHS_PER_BLOCK + 1) / 2)
+                                     : static_cast<std::size_t>(PATHS_PER_BLOCK) * numSteps;
+
+    BankHeader header{};
+    std::memcpy(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC));
+    header.version = BANK_VERSION;
+    header.method = static_cast<uint32_t>(method);
+    header.seed = seed;
+    header.blocks = blockCount(numPaths);
+    header.variatesPerBlock = perBlock;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create variate bank: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Поток каждого блока — тот же, что генерирует движок
+    const NormalGenerator normals(method);
+    std::vector<double> buffer(perBlock);
+    for (unsigned long long b = 0; b < header.blocks; ++b) {
+        std::mt19937_64 rng = makeStreamRng(seed, STREAM_PATH_BLOCKS, b);
+        normals.fill(rng, buffer.data(), perBlock);
+        out.write(reinterpret_cast<const char*>(buffer.data()),
+                  static_cast<std::streamsize>(perBlock * sizeof(double)));
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write variate bank: " + path);
+    }
+}
+
+VariateBank::VariateBank(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open variate bank: " + path);
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map variate bank: " + path);
+    }
+    m_file = file;
+    m_mappingHandle = mapping;
+    m_mapping = view;
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open variate bank: " + path);
+    }
+    struct stat st {};
+    void* view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);  // Отображение остается действительным и после закрытия дескриптора
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Cannot map variate bank: " + path);
+    }
+    m_mapping = view;
+    m_size = static_cast<std::size_t>(st.st_size);
+    // Потоки читают свои диапазоны блоков последовательно
+    ::posix_madvise(m_mapping, m_size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    BankHeader header{};
+    bool valid = m_size >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, m_mapping, sizeof(header));
+        valid = std::memcmp(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC)) == 0 &&
+                header.version == BANK_VERSION &&
+                header.method <= static_cast<uint32_t>(NormalMethod::InverseCdf) &&
+                header.variatesPerBlock > 0 &&
+                header.blocks <= (m_size - sizeof(header)) / sizeof(double) /
+                                     header.variatesPerBlock &&
+                m_size == sizeof(header) +
+                              header.blocks * header.variatesPerBlock * sizeof(double);
+    }
+    if (!valid) {
+        unmap();
+        throw std::runtime_error("Invalid variate bank file: " + path);
+    }
+    m_seed = header.seed;
+    m_method = static_cast<NormalMethod>(header.method);
+    m_blocks = header.blocks;
+    m_variatesPerBlock = static_cast<std::size_t>(header.variatesPerBlock);
+    m_data = reinterpret_cast<const double*>(static_cast<const char*>(m_mapping) +
+                                             sizeof(header));
+}
+
+VariateBank::~VariateBank() { unmap(); }
+
+void VariateBank::unmap() noexcept {
+    if (!m_mapping) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_mapping);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_file);
+#else
+    ::munmap(m_mapping, m_size);
+#endif
+    m_mapping = nullptr;
+}
+
+const double* VariateBank::stream(uint64_t seed, NormalMethod method, unsigned long long block,
+                                  std::size_t count) const noexcept {
+    if (seed != m_seed || method != m_method || block >= m_blocks || count > m_variatesPerBlock) {
+        return nullptr;
+    }
+    return m_data + block * m_variatesPerBlock;
+}
+
+}  // namespace mcopt
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "NormalGenerator.hpp"
+
+/**
+ * @file VariateBank.hpp
+ * @brief Банк заранее сгенерированных нормальных величин в отображаемом в память файле.
+ */
+
+namespace mcopt {
+
+/**
+ * @class VariateBank
+ * @brief Read-only, memory-mapped file of precomputed normal variates shared by engines for
+ * common-random-number repricing.
+ *
+ * The file holds, for one (seed, NormalMethod), the normal stream of each RNG block of
+ * MonteCarloEngine's European and Asian kernels: block b is the first `variatesPerBlock()`
+ * outputs of `NormalGenerator::fill()` on `makeStreamRng(seed, STREAM_PATH_BLOCKS, b)`. The
+ * kernels consume a block's stream in order, batch by batch and within a batch step by step,
+ * so the variate of (path, step) sits at a fixed offset of its block and a bank-backed run is
+ * bit-identical to a live one. Engines read the mapping in place (double precision, no copy),
+ * each thread sequentially over its own block range; the mapping is shared through the page
+ * cache by all engines and processes that open the same file.
+ *
+ * Layout: a 64-byte header (magic, version, normal method, seed, block count, variates per
+ * block; native byte order) followed by the blocks as contiguous doubles.
+ */
+class VariateBank {
+   public:
+    /**
+     * @brief Generates a bank file sized for runs of up to `numPaths` paths.
+     *
+     * A European run (numSteps = 0) draws one normal per antithetic pair, an Asian run one
+     * normal per path and step; a bank built for an Asian run also covers European runs with
+     * the same number of paths.
+     * @param path File to (over)write.
+     * @param seed Engine seed.
+     * @param method Normal generation method of the engine.
+     * @param numPaths Largest number of paths per run.
+     * @param numSteps 0 for European runs, otherwise the Asian time steps.
+     * @throws std::invalid_argument If numPaths is 0.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void create(const std::string& path, uint64_t seed, NormalMethod method,
+                       unsigned long long numPaths, unsigned int numSteps = 0);
+
+    /**
+     * @brief Maps an existing bank file read-only.
+     * @throws std::runtime_error If the file cannot be opened or mapped, or its header or size is
+     * invalid.
+     */
+    explicit VariateBank(const std::string& path);
+    ~VariateBank();
+
+    VariateBank(const VariateBank&) = delete;
+    VariateBank& operator=(const VariateBank&) = delete;
+
+    /**
+     * @brief First `count` variates of a block's stream, or nullptr if the bank does not cover
+     * them (other seed or method, block beyond the bank or count above variatesPerBlock());
+     * the caller then generates the block live.
+     */
+    [[nodiscard]] const double* stream(uint64_t seed, NormalMethod method,
+                                       unsigned long long block,
+                                       std::size_t count) const noexcept;
+
+    [[nodiscard]] uint64_t seed() const noexcept { return m_seed; }
+    [[nodiscard]] NormalMethod method() const noexcept { return m_method; }
+    [[nodiscard]] unsigned long long blocks() const noexcept { return m_blocks; }
+    [[nodiscard]] std::size_t variatesPerBlock() const noexcept { return m_variatesPerBlock; }
+
+   private:
+    void unmap() noexcept;
+
+    uint64_t m_seed = 0;
+    NormalMethod m_method = NormalMethod::Ziggurat;
+    unsigned long long m_blocks = 0;
+    std::size_t m_variatesPerBlock = 0;
+    const double* m_data = nullptr;
+
+    /// @brief Whole mapping (header included) and its size.
+    void* m_mapping = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+}  // namespace mcopt
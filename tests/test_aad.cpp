@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "../src/Constants.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double K = 100.0;
+const double T = 1.0;
+const double r = 0.05;
+const double sigma = 0.2;
+const uint64_t SEED = 11;
+
+double asianPrice(double spot, double rate, double vol, unsigned long long paths,
+                  unsigned int steps) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, spot, T, rate, vol, SEED);
+    return engine.calculateAsianPrice(paths, steps);
+}
+
+// Пользовательский колл без derivative(): используется разностная производная по умолчанию
+class PlainCall : public mcopt::Payoff {
+   public:
+    double operator()(double spot) const noexcept override { return std::max(spot - K, 0.0); }
+    std::string name() const override { return "PlainCall"; }
+};
+
+}  // namespace
+
+// Тест 1: Сопряженные греки совпадают с конечными разностями на общих случайных числах
+TEST(AdjointTest, AsianGreeksMatchBumpAndReprice) {
+    const unsigned long long paths = 40'000;
+    const unsigned int steps = 24;
+
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, SEED);
+    mcopt::AsianSensitivities s = engine.calculateAsianSensitivities(paths, steps);
+
+    EXPECT_EQ(s.price, engine.calculateAsianPrice(paths, steps));
+    ASSERT_EQ(s.bucketVega.size(), steps);
+
+    const double hS = 0.01 * S0;
+    const double hVol = 1e-3;
+    const double hRate = 1e-4;
+    double fdDelta = (asianPrice(S0 + hS, r, sigma, paths, steps) -
+                      asianPrice(S0 - hS, r, sigma, paths, steps)) / (2.0 * hS);
+    double fdVega = (asianPrice(S0, r, sigma + hVol, paths, steps) -
+                     asianPrice(S0, r, sigma - hVol, paths, steps)) / (2.0 * hVol);
+    double fdRho = (asianPrice(S0, r + hRate, sigma, paths, steps) -
+                    asianPrice(S0, r - hRate, sigma, paths, steps)) / (2.0 * hRate);
+
+    EXPECT_NEAR(s.delta, fdDelta, 2e-3);
+    EXPECT_NEAR(s.vega, fdVega, 0.05);
+    EXPECT_NEAR(s.rho, fdRho, 0.05);
+
+    // Ранние шаги влияют на все последующие точки среднего — их вега больше
+    for (double v : s.bucketVega) EXPECT_GT(v, 0.0);
+    EXPECT_GT(s.bucketVega.front(), s.bucketVega.back());
+}
+
+// Тест 2: Один шаг — европейский колл, сверка с формулами Блэка–Шоулза
+TEST(AdjointTest, SingleStepMatchesBlackScholesGreeks) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, SEED);
+    mcopt::AsianSensitivities s = engine.calculateAsianSensitivities(400'000, 1);
+
+    double sqrtT = std::sqrt(T);
+    double d1 = (std::log(S0 / K) + (r + 0.5 * sigma * sigma) * T) / (sigma * sqrtT);
+    double d2 = d1 - sigma * sqrtT;
+    double pdf = mcopt::math::INV_SQRT_2PI * std::exp(-0.5 * d1 * d1);
+    double delta = 0.5 * std::erfc(-d1 / mcopt::math::SQRT2);
+    double vega = S0 * pdf * sqrtT;
+    double rho = K * T * std::exp(-r * T) * 0.5 * std::erfc(-d2 / mcopt::math::SQRT2);
+
+    EXPECT_NEAR(s.delta, delta, 0.01 * delta);
+    EXPECT_NEAR(s.vega, vega, 0.02 * vega);
+    EXPECT_NEAR(s.rho, rho, 0.02 * rho);
+    ASSERT_EQ(s.bucketVega.size(), 1U);
+    EXPECT_EQ(s.bucketVega.front(), s.vega);
+
+    EXPECT_THROW((void)engine.calculateAsianSensitivities(1000, 0), std::invalid_argument);
+}
+
+// Тест 3: Выплата без derivative() дает те же сопряженные греки, что и точная производная
+TEST(AdjointTest, DefaultDerivativeMatchesExact) {
+    PlainCall plain;
+    EXPECT_NEAR(plain.derivative(120.0), 1.0, 1e-9);
+    EXPECT_EQ(plain.derivative(80.0), 0.0);
+
+    auto exactPayoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine exact(exactPayoff, S0, T, r, sigma, SEED);
+    mcopt::MonteCarloEngine numeric(std::make_shared<PlainCall>(), S0, T, r, sigma, SEED);
+    auto a = exact.calculateAsianSensitivities(40'000, 12);
+    auto b = numeric.calculateAsianSensitivities(40'000, 12);
+    EXPECT_EQ(b.price, a.price);
+    EXPECT_NEAR(b.delta, a.delta, 1e-4);
+    EXPECT_NEAR(b.vega, a.vega, 1e-3);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+
+// Тест 1: Завершенный асинхронный расчет совпадает с блокирующим
+TEST(AsyncPricingTest, CompletedRunMatchesBlockingCall) {
+    auto payoff = std::make_shared<mcopt::PayoffCall>(100.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 7);
+    engine.setNumThreads(3);
+    const unsigned long long paths = 200'001;
+
+    mcopt::PricingHandle handle = engine.calculatePriceAsync(paths);
+    mcopt::PricingResult result = handle.get();
+    EXPECT_FALSE(handle.cancelled());
+    EXPECT_EQ(result.paths, paths);
+    EXPECT_EQ(result.price, engine.calculatePrice(paths));
+    EXPECT_GT(result.standardError, 0.0);
+
+    mcopt::PricingProgress progress = handle.progress();
+    EXPECT_EQ(progress.pathsDone, paths);
+    EXPECT_EQ(progress.totalPaths, paths);
+    EXPECT_NEAR(progress.estimate, result.price, 1e-9);
+    EXPECT_NEAR(progress.standardError, result.standardError, 1e-9);
+    EXPECT_THROW((void)handle.get(), std::logic_error);
+}
+
+// Тест 2: Отмена возвращает оценку по уже рассчитанным блокам
+TEST(AsyncPricingTest, CancellationReturnsPartialEstimate) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 7);
+    engine.setNumThreads(2);
+    const unsigned long long paths = 20'000'000;  // Заведомо дольше, чем ждет тест
+
+    mcopt::PricingHandle handle = engine.calculateAsianPriceAsync(paths, 64);
+    while (handle.progress().pathsDone == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    mcopt::PricingProgress running = handle.progress();
+    EXPECT_GT(running.estimate, 0.0);
+    EXPECT_FALSE(handle.ready());
+
+    handle.cancel();
+    ASSERT_TRUE(handle.waitFor(std::chrono::seconds(30)));
+    mcopt::PricingResult result = handle.get();
+    EXPECT_TRUE(handle.cancelled());
+    EXPECT_GT(result.paths, 0ULL);
+    EXPECT_LT(result.paths, paths);
+    EXPECT_EQ(result.paths, handle.progress().pathsDone);
+
+    double reference = engine.calculateAsianPrice(100'000, 64);
+    EXPECT_NEAR(result.price, reference, 5.0 * result.standardError + 0.1);
+}
+
+// Тест 3: Валидация и независимость от жизни движка
+TEST(AsyncPricingTest, HandleOutlivesEngine) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::PricingHandle handle = [&]() {
+        mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 7);
+        EXPECT_THROW((void)engine.calculateAsianPriceAsync(1000, 0), std::invalid_argument);
+        return engine.calculateAsianPriceAsync(20'000, 16);
+    }();
+    mcopt::PricingResult result = handle.get();
+    EXPECT_EQ(result.paths, 20'000ULL);
+    EXPECT_GT(result.price, 0.0);
+}
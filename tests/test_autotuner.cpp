@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "../src/AutoTuner.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/Serialization.hpp"
+
+// Проверка автонастройки
+
+static mcopt::MonteCarloEngine makeEngine(std::shared_ptr<mcopt::Payoff> payoff) {
+    return mcopt::MonteCarloEngine(std::move(payoff), 100.0, 1.0, 0.05, 0.2, 77);
+}
+
+// Тест 1: План достигает целевой ошибки, прогноз времени и ошибки заполнен
+TEST(AutoTunerTest, PlanReachesTargetError) {
+    mcopt::AutoTuner tuner("", 1ULL << 14);
+    auto engine = makeEngine(std::make_shared<mcopt::PayoffCall>(100.0));
+
+    const double target = 0.02;
+    mcopt::TunedResult tuned = tuner.price(engine, 0, target);
+    EXPECT_GT(tuned.plan.predictedSeconds, 0.0);
+    EXPECT_GE(tuned.plan.threads, 1U);
+    EXPECT_EQ(tuned.result.paths, tuned.plan.paths);
+    EXPECT_NEAR(tuned.plan.predictedStandardError, target, 0.1 * target);
+    EXPECT_LT(tuned.result.standardError, 1.3 * target);
+    EXPECT_NEAR(tuned.result.price, 10.4506, 4.0 * tuned.result.standardError);
+
+    // Класс продукта настроен один раз
+    EXPECT_TRUE(tuner.find(mcopt::AutoTuner::productClass(engine, 0)).has_value());
+    EXPECT_FALSE(tuner.find(mcopt::AutoTuner::productClass(engine, 16)).has_value());
+}
+
+// Тест 2: Профиль сохраняется в файл и читается без повторной настройки
+TEST(AutoTunerTest, ProfileRoundTrip) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "mcopt_tuning_test.txt").string();
+    std::remove(path.c_str());
+
+    auto engine = makeEngine(std::make_shared<mcopt::PayoffAsianCall>(100.0));
+    const std::string key = mcopt::AutoTuner::productClass(engine, 16);
+    mcopt::TuningEntry tuned{};
+    {
+        mcopt::AutoTuner tuner(path, 1ULL << 14);
+        tuned = tuner.tune(engine, 16);
+    }
+
+    mcopt::AutoTuner reloaded(path, 1ULL << 14);
+    auto entry = reloaded.find(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->method, tuned.method);
+    EXPECT_EQ(entry->precision, tuned.precision);
+    EXPECT_EQ(entry->variancePerPath, tuned.variancePerPath);
+    ASSERT_EQ(entry->timings.size(), tuned.timings.size());
+    EXPECT_EQ(entry->timings.back().secondsPerPath, tuned.timings.back().secondsPerPath);
+    std::remove(path.c_str());
+}
+
+// Тест 3: С временной структурой доступны только обычные ядра
+TEST(AutoTunerTest, TermStructureUsesPlainKernels) {
+    mcopt::AutoTuner tuner("", 1ULL << 14);
+    auto engine = makeEngine(std::make_shared<mcopt::PayoffPut>(100.0));
+    engine.setVolCurve(mcopt::PiecewiseConstantCurve({0.5}, {0.25, 0.15}));
+
+    const mcopt::TuningEntry& entry = tuner.tune(engine, 0);
+    EXPECT_EQ(entry.method, mcopt::VarianceReduction::Antithetic);
+    EXPECT_THROW(static_cast<void>(tuner.plan(engine, 0, 0.0)), std::invalid_argument);
+}
+
+// Тест 4: Стоимость пилота входит в прогноз; по запросу берется сохраненная дисперсия
+TEST(AutoTunerTest, PilotCostAndStoredVariance) {
+    mcopt::AutoTuner tuner("", 1ULL << 14);
+    auto engine = makeEngine(std::make_shared<mcopt::PayoffCall>(100.0));
+    const double target = 0.05;
+
+    mcopt::PricingPlan piloted = tuner.plan(engine, 0, target);
+    EXPECT_GT(piloted.pilotSeconds, 0.0);
+    EXPECT_GT(piloted.predictedSeconds, piloted.pilotSeconds);
+
+    const mcopt::TuningEntry entry = *tuner.find(mcopt::AutoTuner::productClass(engine, 0));
+    mcopt::PricingPlan reused = tuner.plan(engine, 0, target, true);
+    EXPECT_EQ(reused.pilotSeconds, 0.0);
+    EXPECT_EQ(reused.predictedStandardError,
+              std::sqrt(entry.variancePerPath / static_cast<double>(reused.paths)));
+}
+
+// Тест 5: Метод или точность вне перечислений отклоняются как поврежденный профиль
+TEST(AutoTunerTest, RejectsUnknownEnumValues) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "mcopt_tuning_bad.txt").string();
+    const unsigned int hw = std::max(1U, std::thread::hardware_concurrency());
+    auto write = [&](const char* fields) {
+        std::ofstream file(path, std::ios::trunc);
+        file << "MCTUNE 1 " << hw << " 1\nCall/0\n"
+             << fields << " 4607182418800017408 1 1 0 4607182418800017408\n";
+    };
+    write("3 1");
+    EXPECT_NO_THROW(mcopt::AutoTuner(path, 1ULL << 14));
+    for (const char* fields : {"4 0", "0 2", "-1 0"}) {
+        write(fields);
+        EXPECT_THROW(mcopt::AutoTuner(path, 1ULL << 14), std::runtime_error) << fields;
+    }
+    std::remove(path.c_str());
+}
+
+// Тест 6: Для LHS число путей округляется до целых реплик, и прогон использует их все
+TEST(AutoTunerTest, LatinHypercubePathsAreWholeReplicates) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "mcopt_tuning_lhs.txt").string();
+    auto engine = makeEngine(std::make_shared<mcopt::PayoffCall>(100.0));
+    {
+        // Запись LHS с дисперсией 500.25: при SE 0.5 нужно 2001 путь
+        std::ofstream file(path, std::ios::trunc);
+        file << "MCTUNE 1 " << std::max(1U, std::thread::hardware_concurrency()) << " 1\n"
+             << mcopt::AutoTuner::productClass(engine, 0) << "\n2 0 "
+             << mcopt::doubleToBits(500.25) << " 1 1 0 " << mcopt::doubleToBits(1e-8) << '\n';
+    }
+    mcopt::AutoTuner tuner(path, 1ULL << 14);
+    std::remove(path.c_str());
+
+    mcopt::TunedResult tuned = tuner.price(engine, 0, 0.5, true);
+    EXPECT_EQ(tuned.plan.method, mcopt::VarianceReduction::LatinHypercube);
+    EXPECT_EQ(tuned.plan.paths, 2048U);  // 32 реплики x 2 пути на пару
+    EXPECT_EQ(tuned.result.paths, tuned.plan.paths);
+    EXPECT_LE(tuned.plan.predictedStandardError, 0.5);
+}
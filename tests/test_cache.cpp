@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/RandomStream.hpp"
+#include "../src/ResultCache.hpp"
+
+// Проверка кэша результатов
+
+namespace {
+
+// Наследник колла со своей выплатой: те же name() и strike(), что у PayoffCall
+class CappedCall : public mcopt::PayoffCall {
+   public:
+    using PayoffCall::PayoffCall;
+    double operator()(double spot) const noexcept override {
+        return std::min(PayoffCall::operator()(spot), 10.0);
+    }
+};
+
+}  // namespace
+
+static mcopt::MonteCarloEngine makeEngine(double spot) {
+    auto payoff = std::make_shared<mcopt::PayoffCall>(100.0);
+    return mcopt::MonteCarloEngine(payoff, spot, 1.0, 0.05, 0.2, 321);
+}
+
+// Тест 1: Повторный запрос отвечает из кэша тем же значением
+TEST(ResultCacheTest, IdenticalRequestHit) {
+    auto cache = std::make_shared<mcopt::ResultCache>(16);
+    auto engine = makeEngine(100.0);
+    double uncached = engine.calculatePrice(100'000);
+
+    engine.setResultCache(cache);
+    double first = engine.calculatePrice(100'000);
+    EXPECT_EQ(cache->size(), 1U);
+    double second = engine.calculatePrice(100'000);
+
+    EXPECT_EQ(first, uncached);
+    EXPECT_EQ(second, uncached);
+
+    // Другой спот — другой ключ
+    auto other = makeEngine(101.0);
+    other.setResultCache(cache);
+    (void)other.calculatePrice(100'000);
+    EXPECT_EQ(cache->size(), 2U);
+}
+
+// Тест 2: Догрузка путей дает тот же результат, что и расчет с нуля
+TEST(ResultCacheTest, IncrementalRefinementIsExact) {
+    const unsigned long long small = 3 * mcopt::PATHS_PER_BLOCK + 11;
+    const unsigned long long large = 7 * mcopt::PATHS_PER_BLOCK + 5;
+
+    double fresh = makeEngine(100.0).calculatePrice(large);
+    double freshAsian = 0.0;
+    {
+        auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+        mcopt::MonteCarloEngine asian(payoff, 100.0, 1.0, 0.05, 0.2, 321);
+        freshAsian = asian.calculateAsianPrice(large, 8);
+    }
+
+    auto cache = std::make_shared<mcopt::ResultCache>(16);
+    auto engine = makeEngine(100.0);
+    engine.setResultCache(cache);
+    (void)engine.calculatePrice(small);
+    EXPECT_EQ(engine.calculatePrice(large), fresh);
+    EXPECT_EQ(cache->size(), 1U);  // Запись расширена, а не продублирована
+
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine asian(payoff, 100.0, 1.0, 0.05, 0.2, 321);
+    asian.setResultCache(cache);
+    (void)asian.calculateAsianPrice(small, 8);
+    EXPECT_EQ(asian.calculateAsianPrice(large, 8), freshAsian);
+
+    // Запрос меньшего числа путей не портит накопленную запись
+    EXPECT_EQ(engine.calculatePrice(small), makeEngine(100.0).calculatePrice(small));
+    EXPECT_EQ(engine.calculatePrice(large), fresh);
+}
+
+// Тест 3: LRU-вытеснение при ограниченной емкости
+TEST(ResultCacheTest, LruEviction) {
+    mcopt::ResultCache cache(2);
+    mcopt::CacheEntry entry{};
+    entry.completeBlocks = 1;
+
+    cache.store("a", entry);
+    cache.store("b", entry);
+    (void)cache.find("a");  // "a" становится самой свежей
+    cache.store("c", entry);
+
+    EXPECT_EQ(cache.size(), 2U);
+    EXPECT_TRUE(cache.find("a").has_value());
+    EXPECT_FALSE(cache.find("b").has_value());
+    EXPECT_TRUE(cache.find("c").has_value());
+
+    EXPECT_THROW(mcopt::ResultCache(0), std::invalid_argument);
+}
+
+// Тест 4: Сохранение на диск между запусками
+TEST(ResultCacheTest, PersistenceBetweenRuns) {
+    std::string path =
+        (std::filesystem::temp_directory_path() / "mcopt_cache_test.txt").string();
+    std::remove(path.c_str());
+
+    double price = 0.0;
+    {
+        auto cache = std::make_shared<mcopt::ResultCache>(8, path);
+        auto engine = makeEngine(100.0);
+        engine.setResultCache(cache);
+        price = engine.calculatePrice(50'000);
+    }  // Деструктор записывает файл
+
+    auto restored = std::make_shared<mcopt::ResultCache>(8, path);
+    EXPECT_EQ(restored->size(), 1U);
+    auto engine = makeEngine(100.0);
+    engine.setResultCache(restored);
+    EXPECT_EQ(engine.calculatePrice(50'000), price);
+
+    std::remove(path.c_str());
+}
+
+// Тест 5: Греки берут каждый сдвинутый спот из кэша; базовый спот общий с calculatePrice()
+TEST(ResultCacheTest, GreeksUseCache) {
+    const unsigned long long paths = 2 * mcopt::PATHS_PER_BLOCK + 7;
+    auto reference = makeEngine(100.0);
+    mcopt::Greeks uncached = reference.calculateGreeks(paths);
+
+    auto cache = std::make_shared<mcopt::ResultCache>(16);
+    auto engine = makeEngine(100.0);
+    engine.setResultCache(cache);
+    mcopt::Greeks first = engine.calculateGreeks(paths);
+    EXPECT_EQ(cache->size(), 3U);  // S, S + h, S - h
+    EXPECT_EQ(cache->hits(), 0U);
+
+    mcopt::Greeks second = engine.calculateGreeks(paths);
+    EXPECT_EQ(cache->hits(), 3U);
+    EXPECT_EQ(engine.calculatePrice(paths), first.price);
+    EXPECT_EQ(cache->hits(), 4U);
+
+    for (const auto* g : {&first, &second}) {
+        EXPECT_EQ(g->price, uncached.price);
+        EXPECT_EQ(g->delta, uncached.delta);
+        EXPECT_EQ(g->gamma, uncached.gamma);
+    }
+
+    // Догрузка путей продолжает записи всех трех спотов
+    const unsigned long long more = 4 * mcopt::PATHS_PER_BLOCK + 1;
+    EXPECT_EQ(engine.calculateGreeks(more).delta, reference.calculateGreeks(more).delta);
+    EXPECT_EQ(cache->size(), 3U);
+}
+
+// Тест 6: Наследник встроенной выплаты не делит запись с базовым типом и не кэшируется
+TEST(ResultCacheTest, DerivedPayoffBypassesCache) {
+    auto cache = std::make_shared<mcopt::ResultCache>(16);
+    auto plain = makeEngine(100.0);
+    mcopt::MonteCarloEngine capped(std::make_shared<CappedCall>(100.0), 100.0, 1.0, 0.05, 0.2,
+                                   321);
+    const double cappedUncached = capped.calculatePrice(50'000);
+    plain.setResultCache(cache);
+    capped.setResultCache(cache);
+
+    const double plainPrice = plain.calculatePrice(50'000);
+    EXPECT_EQ(capped.calculatePrice(50'000), cappedUncached);
+    EXPECT_LT(cappedUncached, plainPrice);
+    EXPECT_EQ(capped.calculateSpotLadder({100.0}, 50'000)[0].price, cappedUncached);
+    EXPECT_EQ(cache->size(), 1U);
+    EXPECT_EQ(cache->hits(), 0U);
+}
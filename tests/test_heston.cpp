@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/Heston.hpp"
+#include "../src/HestonEngine.hpp"
+#include "../src/Payoff.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double r = 0.03;
+const mcopt::HestonParameters market{0.04, 1.5, 0.06, 0.6, -0.7};
+
+// Поверхность 8 сроков x 25 страйков: OTM-путы ниже спота, OTM-коллы выше
+std::vector<mcopt::HestonQuote> makeSurface(const mcopt::HestonParameters& p) {
+    mcopt::HestonCOSPricer pricer(S0, r);
+    std::vector<mcopt::HestonQuote> quotes;
+    for (double T : {0.1, 0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0}) {
+        for (int i = 0; i < 25; ++i) {
+            double K = 60.0 + 3.75 * i;
+            auto type = (K < S0) ? mcopt::OptionType::Put : mcopt::OptionType::Call;
+            quotes.push_back({T, K, pricer.price(p, T, K, type), type});
+        }
+    }
+    return quotes;
+}
+
+}  // namespace
+
+// Тест 1: Эталон Fang-Oosterlee, паритет колл-пут и аналитический градиент против разностей
+TEST(HestonTest, COSPricerAndGradients) {
+    const mcopt::HestonParameters fo{0.0175, 1.5768, 0.0398, 0.5751, -0.5711};
+    mcopt::HestonCOSPricer standard(100.0, 0.0);
+    EXPECT_NEAR(standard.price(fo, 1.0, 100.0, mcopt::OptionType::Call), 5.785155450, 1e-6);
+    mcopt::HestonCOSPricer wide(100.0, 0.0, 1024, 40.0);
+    EXPECT_NEAR(wide.price(fo, 1.0, 100.0, mcopt::OptionType::Call), 5.785155450, 1e-7);
+
+    mcopt::HestonCOSPricer pricer(S0, r);
+    const double T = 0.75;
+    auto slice = pricer.makeSlice(T, {80.0, 100.0, 125.0},
+                                  {mcopt::OptionType::Put, mcopt::OptionType::Call,
+                                   mcopt::OptionType::Call},
+                                  market);
+    double prices[3];
+    mcopt::HestonGradient gradients[3];
+    pricer.evaluate(market, slice, prices, gradients);
+    EXPECT_NEAR(prices[1] - pricer.price(market, T, 100.0, mcopt::OptionType::Put),
+                S0 - 100.0 * std::exp(-r * T), 1e-10);
+
+    for (std::size_t j = 0; j < 5; ++j) {
+        const double h = 1e-6;
+        double x[5] = {market.v0, market.kappa, market.theta, market.sigma, market.rho};
+        x[j] += h;
+        double up[3];
+        pricer.evaluate({x[0], x[1], x[2], x[3], x[4]}, slice, up);
+        x[j] -= 2.0 * h;
+        double down[3];
+        pricer.evaluate({x[0], x[1], x[2], x[3], x[4]}, slice, down);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_NEAR(gradients[i][j], (up[i] - down[i]) / (2.0 * h),
+                        1e-5 * (1.0 + std::abs(gradients[i][j])));
+        }
+    }
+    EXPECT_THROW(static_cast<void>(pricer.price({0.04, 1.5, 0.06, 0.6, -1.5}, T, 100.0,
+                                                mcopt::OptionType::Call)),
+                 std::invalid_argument);
+}
+
+// Тест 2: Калибровка к 200 котировкам восстанавливает параметры
+TEST(HestonTest, CalibrationRecoversParameters) {
+    mcopt::HestonCalibrator calibrator(S0, r, makeSurface(market));
+
+    auto fit = calibrator.calibrate({0.02, 3.0, 0.03, 0.3, -0.2});
+
+    EXPECT_TRUE(fit.converged);
+    EXPECT_LT(fit.rmse, 1e-8);
+    EXPECT_NEAR(fit.parameters.v0, market.v0, 1e-6);
+    EXPECT_NEAR(fit.parameters.kappa, market.kappa, 1e-4);
+    EXPECT_NEAR(fit.parameters.theta, market.theta, 1e-6);
+    EXPECT_NEAR(fit.parameters.sigma, market.sigma, 1e-5);
+    EXPECT_NEAR(fit.parameters.rho, market.rho, 1e-5);
+
+    // Параллельная оценка срезов не меняет результат
+    calibrator.setNumThreads(1);
+    auto serial = calibrator.calibrate({0.02, 3.0, 0.03, 0.3, -0.2});
+    EXPECT_EQ(serial.parameters.kappa, fit.parameters.kappa);
+    EXPECT_EQ(serial.iterations, fit.iterations);
+}
+
+// Тест 3: Монте-Карло по схеме QE сходится к COS-цене
+TEST(HestonTest, MonteCarloMatchesCOS) {
+    mcopt::HestonCOSPricer pricer(S0, r);
+    const double T = 1.0;
+    auto payoff = std::make_shared<mcopt::PayoffCall>(105.0);
+    mcopt::HestonEngine engine(payoff, S0, T, r, market, 11);
+
+    auto result = engine.calculatePrice(400'000, 32);
+    double exact = pricer.price(market, T, 105.0, mcopt::OptionType::Call);
+    EXPECT_NEAR(result.price, exact, 4.0 * result.standardError + 0.01);
+
+    // Азиатский колл дешевле европейского; результат не зависит от числа потоков
+    auto asianPayoff = std::make_shared<mcopt::PayoffAsianCall>(105.0);
+    mcopt::HestonEngine asian(asianPayoff, S0, T, r, market, 11);
+    auto avg = asian.calculateAsianPrice(100'000, 24);
+    EXPECT_LT(avg.price, exact);
+    asian.setNumThreads(3);
+    EXPECT_EQ(asian.calculateAsianPrice(100'000, 24).price, avg.price);
+    EXPECT_THROW(static_cast<void>(asian.calculateAsianPrice(1000, 0)), std::invalid_argument);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "../src/Analytical.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+
+// Тест 1: Глубоко OTM колл — несмещенная оценка и выигрыш в дисперсии на порядки
+TEST(ImportanceSamplingTest, DeepOutOfTheMoneyCall) {
+    double S0 = 100.0;
+    double K = 180.0;
+    double T = 0.5;
+    double r = 0.01;
+    double sigma = 0.2;
+
+    auto exact =
+        mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, sigma, mcopt::OptionType::Call);
+    auto payoff = std::make_shared<mcopt::PayoffCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, 123);
+
+    mcopt::ImportanceSamplingResult is = engine.calculatePriceIS(100'000);
+    ASSERT_EQ(is.drift.size(), 1U);
+    EXPECT_GT(is.drift[0], 3.0);  // Сдвиг к страйку: ln(K/S0) / (sigma sqrt T) ~ 4.2
+    EXPECT_NEAR(is.price, exact.price, 4.0 * is.standardError);
+    EXPECT_LT(is.standardError, 0.02 * exact.price);
+    EXPECT_GT(is.varianceReduction, 100.0);
+
+    // Пут в другую сторону
+    auto put = std::make_shared<mcopt::PayoffPut>(60.0);
+    mcopt::MonteCarloEngine putEngine(put, S0, T, r, sigma, 123);
+    auto exactPut =
+        mcopt::BlackScholesAnalytical::calculate(S0, 60.0, T, r, sigma, mcopt::OptionType::Put);
+    mcopt::ImportanceSamplingResult isPut = putEngine.calculatePriceIS(100'000);
+    EXPECT_LT(isPut.drift[0], -2.0);
+    EXPECT_NEAR(isPut.price, exactPut.price, 4.0 * isPut.standardError);
+    EXPECT_GT(isPut.varianceReduction, 100.0);
+}
+
+// Тест 2: Азиатский OTM опцион — совпадение с обычным MC, сдвиг по всем шагам
+TEST(ImportanceSamplingTest, AsianOutOfTheMoney) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(130.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 7);
+    const unsigned int steps = 32;
+
+    mcopt::ImportanceSamplingResult is = engine.calculateAsianPriceIS(50'000, steps);
+    ASSERT_EQ(is.drift.size(), steps);
+    // Ранние приращения влияют на большее число точек среднего — сдвиг убывает по времени
+    EXPECT_GT(is.drift.front(), is.drift.back());
+    EXPECT_GT(is.drift.back(), 0.0);
+    EXPECT_GT(is.varianceReduction, 10.0);
+
+    double plain = engine.calculateAsianPrice(1'000'000, steps);
+    EXPECT_NEAR(is.price, plain, 4.0 * is.standardError + 0.01 * plain);
+
+    EXPECT_THROW((void)engine.calculateAsianPriceIS(1000, 0), std::invalid_argument);
+}
+
+// Тест 3: Страйк за 16 SD (DeepOTM): обычный MC дает 0, IS — цену с малой ошибкой
+TEST(ImportanceSamplingTest, StrikeBeyondTenStandardDeviations) {
+    double S0 = 10.0;
+    double K = 100.0;
+    double T = 0.5;
+    double r = 0.01;
+    double sigma = 0.2;
+
+    auto exact =
+        mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, sigma, mcopt::OptionType::Call);
+    auto payoff = std::make_shared<mcopt::PayoffCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, 123);
+    ASSERT_EQ(engine.calculatePrice(100'000), 0.0);
+
+    mcopt::ImportanceSamplingResult is = engine.calculatePriceIS(100'000);
+    EXPECT_GT(is.drift[0], 16.0);  // ln(K/S0) / (sigma sqrt T) ~ 16.3
+    EXPECT_GT(is.price, 0.0);
+    EXPECT_GT(is.standardError, 0.0);
+    EXPECT_NEAR(is.price, exact.price, 4.0 * is.standardError);
+    EXPECT_LT(is.standardError, 0.02 * exact.price);
+    EXPECT_GT(is.varianceReduction, 1e6);
+
+    // Область исполнения дальше 40 SD: вместо точного на вид нуля — исключение
+    auto unreachable = std::make_shared<mcopt::PayoffCall>(1e9);
+    mcopt::MonteCarloEngine far(unreachable, 100.0, 1.0, 0.05, 0.2, 7);
+    EXPECT_THROW((void)far.calculatePriceIS(10'000), std::runtime_error);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../src/Analytical.hpp"
+#include "../src/JumpDiffusion.hpp"
+#include "../src/Payoff.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double r = 0.04;
+const double sigma = 0.15;
+const mcopt::MertonParameters crashes{1.0, -0.2, 0.15};  // Редкие крупные падения
+
+// Пользовательская выплата без страйка (strike() по умолчанию)
+class CappedCall : public mcopt::Payoff {
+   public:
+    double operator()(double spot) const noexcept override {
+        return std::min(std::max(spot - 100.0, 0.0), 20.0);
+    }
+    std::string name() const override { return "CappedCall"; }
+    double derivative(double spot) const noexcept override {
+        return (spot > 100.0 && spot < 120.0) ? 1.0 : 0.0;
+    }
+};
+
+}  // namespace
+
+// Тест 1: Ряд Мертона: без скачков — Блэк-Шоулз, паритет колл-пут выполняется
+TEST(JumpDiffusionTest, MertonSeriesConsistency) {
+    auto bs = mcopt::BlackScholesAnalytical::calculate(S0, 95.0, 0.5, r, sigma,
+                                                       mcopt::OptionType::Call);
+    auto noJumps = mcopt::BlackScholesAnalytical::calculateMerton(S0, 95.0, 0.5, r, sigma, 0.0,
+                                                                  -0.2, 0.15,
+                                                                  mcopt::OptionType::Call);
+    EXPECT_NEAR(noJumps.price, bs.price, 1e-12);
+    EXPECT_NEAR(noJumps.delta, bs.delta, 1e-12);
+
+    auto call = mcopt::BlackScholesAnalytical::calculateMerton(
+        S0, 95.0, 0.5, r, sigma, crashes.intensity, crashes.jumpMean, crashes.jumpVol,
+        mcopt::OptionType::Call);
+    auto put = mcopt::BlackScholesAnalytical::calculateMerton(
+        S0, 95.0, 0.5, r, sigma, crashes.intensity, crashes.jumpMean, crashes.jumpVol,
+        mcopt::OptionType::Put);
+    EXPECT_NEAR(call.price - put.price, S0 - 95.0 * std::exp(-r * 0.5), 1e-10);
+    EXPECT_NEAR(call.delta - put.delta, 1.0, 1e-10);
+}
+
+// Тест 2: Европейский пут одним терминальным шагом совпадает с рядом Мертона
+TEST(JumpDiffusionTest, EuropeanMatchesMertonSeries) {
+    const double K = 90.0;
+    const double T = 0.25;
+    auto payoff = std::make_shared<mcopt::PayoffPut>(K);
+    mcopt::JumpDiffusionEngine engine(payoff, S0, T, r, sigma, crashes, 7);
+
+    auto result = engine.calculatePrice(1'000'000);
+    auto exact = mcopt::BlackScholesAnalytical::calculateMerton(
+        S0, K, T, r, sigma, crashes.intensity, crashes.jumpMean, crashes.jumpVol,
+        mcopt::OptionType::Put);
+    EXPECT_NEAR(result.price, exact.price, 4.0 * result.standardError);
+
+    // Риск обвала делает короткий OTM-пут заметно дороже, чем в GBM
+    auto gbm = mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, sigma, mcopt::OptionType::Put);
+    EXPECT_GT(exact.price, 2.0 * gbm.price);
+}
+
+// Тест 3: Азиатский опцион с пошаговыми скачками: контрольная переменная снижает ошибку
+TEST(JumpDiffusionTest, AsianControlVariate) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::JumpDiffusionEngine engine(payoff, S0, 1.0, r, sigma, crashes, 3);
+
+    auto plain = engine.calculateAsianPrice(200'000, 24, false);
+    auto cv = engine.calculateAsianPrice(200'000, 24, true);
+    EXPECT_LT(cv.standardError, 0.5 * plain.standardError);
+    EXPECT_NEAR(cv.price, plain.price, 4.0 * plain.standardError);
+
+    // Результат не зависит от числа потоков
+    engine.setNumThreads(3);
+    EXPECT_EQ(engine.calculateAsianPrice(200'000, 24, true).price, cv.price);
+    EXPECT_THROW(static_cast<void>(engine.calculateAsianPrice(1000, 0)), std::invalid_argument);
+}
+
+// Тест 4: Выплата без страйка: контрольная переменная пропускается, цена как без нее
+TEST(JumpDiffusionTest, PayoffWithoutStrikeSkipsControlVariate) {
+    auto payoff = std::make_shared<CappedCall>();
+    EXPECT_TRUE(std::isnan(payoff->strike()));
+    mcopt::JumpDiffusionEngine engine(payoff, S0, 1.0, r, sigma, crashes, 3);
+
+    auto plain = engine.calculateAsianPrice(50'000, 12, false);
+    auto cv = engine.calculateAsianPrice(50'000, 12, true);
+    EXPECT_GT(plain.price, 0.0);
+    EXPECT_EQ(cv.price, plain.price);
+    EXPECT_EQ(cv.standardError, plain.standardError);
+}
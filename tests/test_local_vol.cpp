@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/Analytical.hpp"
+#include "../src/LocalVolEngine.hpp"
+#include "../src/LocalVolatility.hpp"
+#include "../src/Payoff.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double r = 0.03;
+
+// Улыбка с наклоном: sigma(y) = 0.2 - 0.1 y + 0.2 y^2, y = log(K / F), слабая временная структура
+mcopt::ImpliedVolSurface makeSmile(std::vector<double>& maturities,
+                                   std::vector<double>& strikes) {
+    maturities = {0.25, 0.5, 1.0, 1.5};
+    strikes.clear();
+    for (double k = 40.0; k <= 220.0; k += 10.0) strikes.push_back(k);
+    std::vector<std::vector<double>> vols;
+    for (double t : maturities) {
+        std::vector<double> row;
+        for (double k : strikes) {
+            double y = std::log(k / (S0 * std::exp(r * t)));
+            row.push_back(0.2 + 0.01 * t - 0.1 * y + 0.2 * y * y);
+        }
+        vols.push_back(row);
+    }
+    return mcopt::ImpliedVolSurface(S0, r, maturities, strikes, vols);
+}
+
+}  // namespace
+
+// Тест 1: Плоская поверхность дает постоянную локальную волатильность и цену Блэка-Шоулза
+TEST(LocalVolTest, FlatSurfaceIsBlackScholes) {
+    std::vector<double> strikes = {50.0, 80.0, 100.0, 120.0, 200.0};
+    std::vector<std::vector<double>> vols(2, std::vector<double>(strikes.size(), 0.25));
+    mcopt::ImpliedVolSurface implied(S0, r, {0.5, 1.0}, strikes, vols);
+    auto surface = std::make_shared<mcopt::LocalVolSurface>(implied, 1.0);
+    EXPECT_EQ(surface->rate(), r);  // Движок дисконтирует по ставке котировок
+
+    for (double t : {0.0, 0.3, 0.75, 1.0}) {
+        for (double s : {30.0, 70.0, 100.0, 150.0, 400.0}) {
+            EXPECT_NEAR((*surface)(t, s), 0.25, 1e-9) << "t=" << t << " S=" << s;
+        }
+    }
+
+    auto call = std::make_shared<mcopt::PayoffCall>(110.0);
+    mcopt::LocalVolEngine engine(call, S0, 1.0, surface);
+    auto result = engine.calculatePrice(200'000, 16);
+    double exact =
+        mcopt::BlackScholesAnalytical::calculate(S0, 110.0, 1.0, r, 0.25, mcopt::OptionType::Call)
+            .price;
+    EXPECT_NEAR(result.price, exact, 4.0 * result.standardError);
+}
+
+// Тест 2: Локальная волатильность воспроизводит входные ванильные цены в пределах ошибки MC
+TEST(LocalVolTest, RepricesVanillaSurface) {
+    std::vector<double> maturities;
+    std::vector<double> strikes;
+    mcopt::ImpliedVolSurface implied = makeSmile(maturities, strikes);
+    auto surface = std::make_shared<mcopt::LocalVolSurface>(implied, 1.0);
+
+    for (double T : {0.5, 1.0}) {
+        for (double K : {80.0, 100.0, 125.0}) {
+            auto payoff = (K < S0) ? std::shared_ptr<mcopt::Payoff>(
+                                         std::make_shared<mcopt::PayoffPut>(K))
+                                   : std::make_shared<mcopt::PayoffCall>(K);
+            auto type = (K < S0) ? mcopt::OptionType::Put : mcopt::OptionType::Call;
+            mcopt::LocalVolEngine engine(payoff, S0, T, surface, 11);
+            auto result = engine.calculatePrice(400'000, static_cast<unsigned int>(100 * T));
+            double vol = implied.impliedVol(T, K);
+            double exact = mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, vol, type).price;
+            // 4 SE плюс небольшой допуск на дискретизацию Эйлера и сетки
+            EXPECT_NEAR(result.price, exact, 4.0 * result.standardError + 0.02)
+                << "T=" << T << " K=" << K;
+        }
+    }
+}
+
+// Тест 3: Проверка аргументов и азиатский опцион дешевле европейского
+TEST(LocalVolTest, AsianAndValidation) {
+    std::vector<double> maturities;
+    std::vector<double> strikes;
+    mcopt::ImpliedVolSurface implied = makeSmile(maturities, strikes);
+    auto surface = std::make_shared<mcopt::LocalVolSurface>(implied, 1.0, 128, 64);
+    auto call = std::make_shared<mcopt::PayoffCall>(100.0);
+
+    mcopt::LocalVolEngine engine(call, S0, 1.0, surface);
+    engine.setNumThreads(3);
+    auto european = engine.calculatePrice(100'000, 32);
+    auto asian = engine.calculateAsianPrice(100'000, 32);
+    EXPECT_LT(asian.price, european.price);
+    engine.setNumThreads(1);
+    EXPECT_EQ(engine.calculateAsianPrice(100'000, 32).price, asian.price);
+
+    EXPECT_THROW(mcopt::LocalVolEngine(call, S0, 2.0, surface), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(engine.calculatePrice(1000, 0)), std::invalid_argument);
+    EXPECT_THROW(mcopt::ImpliedVolSurface(S0, r, {1.0}, {90.0, 100.0}, {{0.2, 0.2}}),
+                 std::invalid_argument);
+}
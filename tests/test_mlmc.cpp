@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+
+// Проверка Multilevel Monte Carlo для азиатского опциона
+
+// Тест 1: Дискретное MLMC совпадает с calculateAsianPrice() на тех же датах мониторинга
+TEST(MLMCTest, MatchesFineGridMonteCarlo) {
+    double S0 = 100.0;
+    double K = 100.0;
+    double T = 1.0;
+    double r = 0.05;
+    double sigma = 0.2;
+    uint64_t seed = 123;
+    const double rmse = 0.02;
+
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, seed);
+
+    mcopt::PricingResult reference = engine.calculateAsianPriceAsync(200'000, 252).get();
+    auto mlmc = engine.calculateDiscreteAsianPriceMLMC(rmse, 252);
+
+    EXPECT_TRUE(mlmc.converged);
+    EXPECT_LE(mlmc.standardError, rmse);
+    EXPECT_EQ(mlmc.levels.back().steps, 252U);  // Последний уровень — сам контракт
+    EXPECT_NEAR(mlmc.price, reference.price, 3.0 * (rmse + reference.standardError));
+
+    // При 12 датах дискретное среднее заметно отличается от непрерывного (трапеции)
+    mcopt::PricingResult monthly = engine.calculateAsianPriceAsync(400'000, 12).get();
+    const double tolerance = 3.0 * (rmse + monthly.standardError);
+    EXPECT_NEAR(engine.calculateDiscreteAsianPriceMLMC(rmse, 12).price, monthly.price, tolerance);
+    EXPECT_GT(std::abs(engine.calculateAsianPriceMLMC(rmse).price - monthly.price), tolerance);
+}
+
+// Тест 2: Структура уровней — дисперсия поправок и число путей убывают с ростом уровня
+TEST(MLMCTest, LevelBreakdown) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 7);
+
+    auto mlmc = engine.calculateAsianPriceMLMC(0.01);
+    ASSERT_GE(mlmc.levels.size(), 3U);
+
+    double sumOfMeans = 0.0;
+    double totalCost = 0.0;
+    for (std::size_t l = 0; l < mlmc.levels.size(); ++l) {
+        const auto& level = mlmc.levels[l];
+        EXPECT_EQ(level.steps, 1U << l);
+        sumOfMeans += level.mean;
+        totalCost += static_cast<double>(level.paths) * level.costPerPath;
+        if (l >= 2) {
+            EXPECT_LT(level.variance, mlmc.levels[l - 1].variance);
+            EXPECT_LE(level.paths, mlmc.levels[l - 1].paths);
+        }
+    }
+    EXPECT_NEAR(sumOfMeans, mlmc.price, 1e-12);
+    EXPECT_DOUBLE_EQ(totalCost, mlmc.totalCost);
+}
+
+// Тест 3: Валидация аргументов
+TEST(MLMCTest, ThrowsOnInvalidInput) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 1);
+
+    EXPECT_THROW((void)engine.calculateAsianPriceMLMC(0.0), std::invalid_argument);
+    EXPECT_THROW((void)engine.calculateAsianPriceMLMC(0.01, 1), std::invalid_argument);
+    EXPECT_THROW((void)engine.calculateAsianPriceMLMC(0.01, 8, 1), std::invalid_argument);
+    EXPECT_THROW((void)engine.calculateDiscreteAsianPriceMLMC(0.01, 0), std::invalid_argument);
+}
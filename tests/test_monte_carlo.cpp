@@ -1,12 +1,27 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
+#include <vector>
 
 #include "../src/Analytical.hpp"
 #include "../src/MCEngine.hpp"
 #include "../src/Payoff.hpp"
 
+namespace {
+
+// Наследник колла со своей выплатой: ядра не должны подменять ее встроенной формулой
+class CappedCall : public mcopt::PayoffCall {
+   public:
+    using PayoffCall::PayoffCall;
+    double operator()(double spot) const noexcept override {
+        return std::min(PayoffCall::operator()(spot), 10.0);
+    }
+};
+
+}  // namespace
+
 // Тест 1: При волатильности близкой к 0, цена MC должна совпадать с внутренней стоимостью
 TEST(MonteCarloTest, ZeroVolatilityLimit) {
     double S0 = 110.0;
@@ -151,3 +166,68 @@ TEST(MonteCarloTest, ConvergenceCheck) {
     // Ошибка на 1М путей должна быть меньше, чем на 10к (в большинстве случаев)
     EXPECT_LT(err1M, err10k);
 }
+
+// Тест 7: Лестница спотов совпадает с отдельными расчетами (общие случайные числа)
+TEST(MonteCarloTest, SpotLadderMatchesIndividualRuns) {
+    double K = 100.0;
+    double T = 1.0;
+    double r = 0.05;
+    double sigma = 0.2;
+    uint64_t seed = 123;
+    unsigned long long paths = 100'001;
+
+    auto payoff = std::make_shared<mcopt::PayoffPut>(K);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, T, r, sigma, seed);
+
+    std::vector<double> shocks = {-0.2, -0.1, -0.01, 0.0, 0.01, 0.1, 0.2};
+    auto ladder = engine.calculateSpotShocks(shocks, paths);
+    ASSERT_EQ(ladder.size(), shocks.size());
+
+    for (std::size_t k = 0; k < shocks.size(); ++k) {
+        mcopt::MonteCarloEngine single(payoff, 100.0 * (1.0 + shocks[k]), T, r, sigma, seed);
+        EXPECT_EQ(ladder[k].price, single.calculatePrice(paths)) << "shock = " << shocks[k];
+        EXPECT_GT(ladder[k].standardError, 0.0);
+    }
+    // Пут убывает по споту
+    for (std::size_t k = 1; k < ladder.size(); ++k) {
+        EXPECT_LT(ladder[k].price, ladder[k - 1].price);
+    }
+
+    auto capped = std::make_shared<CappedCall>(K);
+    mcopt::MonteCarloEngine cappedEngine(capped, 100.0, T, r, sigma, seed);
+    auto cappedLadder = cappedEngine.calculateSpotLadder({90.0, 130.0}, paths);
+    mcopt::MonteCarloEngine cappedSingle(capped, 130.0, T, r, sigma, seed);
+    mcopt::MonteCarloEngine call(std::make_shared<mcopt::PayoffCall>(K), 130.0, T, r, sigma, seed);
+    EXPECT_EQ(cappedLadder[1].price, cappedSingle.calculatePrice(paths));
+    EXPECT_LT(cappedLadder[1].price, 10.0);
+    EXPECT_LT(cappedLadder[1].price, call.calculatePrice(paths));
+}
+
+// Тест 8: Одинарная точность дает ту же оценку в пределах доли стандартной ошибки
+TEST(MonteCarloTest, SinglePrecisionMatchesDouble) {
+    double S0 = 100.0;
+    double K = 100.0;
+    double T = 1.0;
+    double r = 0.05;
+    double sigma = 0.2;
+    uint64_t seed = 123;
+    unsigned long long paths = 400'001;
+
+    auto call = std::make_shared<mcopt::PayoffCall>(K);
+    mcopt::MonteCarloEngine engine(call, S0, T, r, sigma, seed);
+    auto ref = engine.calculateSpotLadder({S0}, paths).front();
+    engine.setPrecision(mcopt::Precision::Single);
+    EXPECT_EQ(engine.precision(), mcopt::Precision::Single);
+    auto single = engine.calculateSpotLadder({S0}, paths).front();
+    EXPECT_NEAR(single.price, ref.price, 0.1 * ref.standardError);
+    EXPECT_NEAR(single.standardError, ref.standardError, 0.01 * ref.standardError);
+    EXPECT_EQ(engine.calculatePrice(paths), single.price);
+
+    auto asian = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine asianEngine(asian, S0, T, r, sigma, seed);
+    double asianRef = asianEngine.calculateAsianPrice(50'000, 64);
+    asianEngine.setPrecision(mcopt::Precision::Single);
+    double asianSingle = asianEngine.calculateAsianPrice(50'000, 64);
+    // Стандартная ошибка азиатской оценки на 50k путях ~0.04
+    EXPECT_NEAR(asianSingle, asianRef, 0.01);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../src/NormalGenerator.hpp"
+#include "../src/RandomStream.hpp"
+
+namespace {
+
+std::vector<double> sample(mcopt::NormalMethod method, std::size_t n) {
+    std::mt19937_64 rng = mcopt::makeStreamRng(2024, 0, 0);
+    mcopt::NormalGenerator normals(method);
+    std::vector<double> z(n);
+    normals.fill(rng, z.data(), n);
+    return z;
+}
+
+// Статистика Колмогорова–Смирнова относительно N(0, 1)
+double ksStatistic(std::vector<double> z) {
+    std::sort(z.begin(), z.end());
+    const double n = static_cast<double>(z.size());
+    double d = 0.0;
+    for (std::size_t i = 0; i < z.size(); ++i) {
+        double cdf = 0.5 * std::erfc(-z[i] / std::sqrt(2.0));
+        d = std::max(d, std::max(static_cast<double>(i + 1) / n - cdf,
+                                 cdf - static_cast<double>(i) / n));
+    }
+    return d;
+}
+
+}  // namespace
+
+// Тест 1: Моменты и KS-тест для обоих методов
+TEST(NormalGeneratorTest, MomentsAndKolmogorovSmirnov) {
+    const std::size_t n = 1'000'000;
+    for (auto method : {mcopt::NormalMethod::Ziggurat, mcopt::NormalMethod::InverseCdf}) {
+        std::vector<double> z = sample(method, n);
+        double m1 = 0.0, m2 = 0.0, m3 = 0.0, m4 = 0.0;
+        for (double x : z) {
+            m1 += x;
+            m2 += x * x;
+            m3 += x * x * x;
+            m4 += x * x * x * x;
+        }
+        m1 /= n;
+        m2 /= n;
+        m3 /= n;
+        m4 /= n;
+
+        // Допуски ~5 стандартных ошибок выборочных моментов
+        EXPECT_NEAR(m1, 0.0, 5.0 * std::sqrt(1.0 / n));
+        EXPECT_NEAR(m2, 1.0, 5.0 * std::sqrt(2.0 / n));
+        EXPECT_NEAR(m3, 0.0, 5.0 * std::sqrt(15.0 / n));
+        EXPECT_NEAR(m4, 3.0, 5.0 * std::sqrt(96.0 / n));
+
+        // Критическое значение KS на уровне 0.1%: 1.95 / sqrt(n)
+        EXPECT_LT(ksStatistic(z), 1.95 / std::sqrt(static_cast<double>(n)));
+    }
+}
+
+// Тест 2: Точность обратной функции распределения
+TEST(NormalGeneratorTest, InverseCdfAccuracy) {
+    EXPECT_NEAR(mcopt::NormalGenerator::inverseCdf(0.5), 0.0, 1e-16);
+    EXPECT_NEAR(mcopt::NormalGenerator::inverseCdf(0.975), 1.959963984540054, 1e-14);
+    EXPECT_NEAR(mcopt::NormalGenerator::inverseCdf(1e-10), -6.361340902404056, 1e-12);
+
+    // Обращение на сетке от центра до далекого хвоста: Phi^{-1}(Phi(x)) = x
+    for (double x = -8.0; x <= 3.0; x += 0.25) {
+        double p = 0.5 * std::erfc(-x / std::sqrt(2.0));
+        EXPECT_NEAR(mcopt::NormalGenerator::inverseCdf(p), x, 1e-12 * (1.0 + std::abs(x)))
+            << "x = " << x;
+    }
+
+    // Пакетная версия совпадает с поэлементной (в том числе на месте)
+    std::vector<double> u = {1e-300, 1e-12, 0.01, 0.07, 0.3, 0.5, 0.8, 0.93, 0.999, 1.0 - 1e-16};
+    std::vector<double> z = u;
+    mcopt::NormalGenerator::inverseCdf(z.data(), z.data(), z.size());
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        EXPECT_EQ(z[i], mcopt::NormalGenerator::inverseCdf(u[i]));
+    }
+    EXPECT_TRUE(std::isinf(mcopt::NormalGenerator::inverseCdf(0.0)));
+}
+
+// Тест 3: Воспроизводимость — одиночные и пакетные вызовы, float и double
+TEST(NormalGeneratorTest, DeterministicStream) {
+    for (auto method : {mcopt::NormalMethod::Ziggurat, mcopt::NormalMethod::InverseCdf}) {
+        std::vector<double> batch = sample(method, 1000);
+
+        std::mt19937_64 rng = mcopt::makeStreamRng(2024, 0, 0);
+        mcopt::NormalGenerator normals(method);
+        for (double expected : batch) {
+            EXPECT_EQ(normals(rng), expected);
+        }
+
+        rng = mcopt::makeStreamRng(2024, 0, 0);
+        std::vector<float> single(batch.size());
+        normals.fill(rng, single.data(), single.size());
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            EXPECT_EQ(single[i], static_cast<float>(batch[i]));
+        }
+    }
+}
+
+// Тест 4: Эталонные значения — одинаковы на всех компиляторах и платформах
+TEST(NormalGeneratorTest, ReferenceValues) {
+    std::mt19937_64 rng = mcopt::makeStreamRng(2024, 0, 0);
+    mcopt::NormalGenerator ziggurat(mcopt::NormalMethod::Ziggurat);
+    EXPECT_EQ(ziggurat(rng), -0x1.8cfeba883ad95p-1);
+    EXPECT_EQ(ziggurat(rng), -0x1.52ffcf50aaa2bp+0);
+    EXPECT_EQ(ziggurat(rng), -0x1.06c7d4fc2510ep+1);
+
+    rng = mcopt::makeStreamRng(2024, 0, 0);
+    mcopt::NormalGenerator inverse(mcopt::NormalMethod::InverseCdf);
+    EXPECT_EQ(inverse(rng), -0x1.cc5a8cff100c2p-2);
+    EXPECT_EQ(inverse(rng), -0x1.b4a9b125040ap+0);
+    EXPECT_EQ(inverse(rng), -0x1.8c26bd95f9652p+0);
+}
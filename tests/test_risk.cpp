@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "../src/Analytical.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/RiskEngine.hpp"
+
+// Проверка сценарного движка VaR/ES
+
+namespace {
+
+// Наследник колла со своей выплатой: формула Блэка-Шоулза к нему неприменима
+class CappedCall : public mcopt::PayoffCall {
+   public:
+    using PayoffCall::PayoffCall;
+    double operator()(double spot) const noexcept override {
+        return std::min(PayoffCall::operator()(spot), 10.0);
+    }
+};
+
+}  // namespace
+
+// Тест 1: Пакетная аналитика совпадает со скалярной формулой
+TEST(RiskEngineTest, BatchAnalyticalMatchesScalar) {
+    std::vector<double> S = {90.0, 100.0, 110.0, 100.0};
+    std::vector<double> K = {100.0, 100.0, 100.0, 120.0};
+    std::vector<double> T = {0.5, 1.0, 2.0, 0.25};
+    std::vector<double> r = {0.01, 0.05, 0.03, 0.0};
+    std::vector<double> sigma = {0.3, 0.2, 0.15, 0.4};
+    std::vector<mcopt::OptionType> type = {mcopt::OptionType::Call, mcopt::OptionType::Put,
+                                           mcopt::OptionType::Call, mcopt::OptionType::Put};
+    std::vector<double> out(S.size());
+
+    mcopt::BlackScholesAnalytical::priceBatch(S.size(), S.data(), K.data(), T.data(), r.data(),
+                                              sigma.data(), type.data(), out.data());
+
+    for (std::size_t i = 0; i < S.size(); ++i) {
+        auto exact = mcopt::BlackScholesAnalytical::calculate(S[i], K[i], T[i], r[i], sigma[i],
+                                                              type[i]);
+        EXPECT_NEAR(out[i], exact.price, 1e-10);
+    }
+}
+
+// Тест 2: Переоценка ванильного портфеля по сценариям совпадает с формулой и не зависит
+// от размера плиток и числа потоков
+TEST(RiskEngineTest, VanillaRevaluation) {
+    mcopt::MarketState base{100.0, 0.03, 0.2};
+    std::vector<mcopt::Position> portfolio = {
+        {std::make_shared<mcopt::PayoffCall>(100.0), 10.0, 1.0},
+        {std::make_shared<mcopt::PayoffPut>(95.0), -5.0, 0.5},
+        {std::make_shared<mcopt::PayoffCall>(110.0), 3.0, 0.25},
+    };
+    auto scenarios = mcopt::ScenarioEngine::monteCarloScenarios(base, 50, 0.5, 0.01, 7);
+
+    mcopt::ScenarioEngine engine(base);
+    engine.setNumThreads(1);
+    auto values = engine.portfolioValues(portfolio, scenarios);
+
+    for (std::size_t s = 0; s < scenarios.size(); ++s) {
+        double spot = base.spot * (1.0 + scenarios[s].spotShock);
+        double rate = base.rate + scenarios[s].rateShock;
+        double vol = base.vol + scenarios[s].volShock;
+        double expected = 0.0;
+        expected += 10.0 * mcopt::BlackScholesAnalytical::calculate(spot, 100.0, 1.0, rate, vol,
+                                                                    mcopt::OptionType::Call)
+                               .price;
+        expected -= 5.0 * mcopt::BlackScholesAnalytical::calculate(spot, 95.0, 0.5, rate, vol,
+                                                                   mcopt::OptionType::Put)
+                              .price;
+        expected += 3.0 * mcopt::BlackScholesAnalytical::calculate(spot, 110.0, 0.25, rate, vol,
+                                                                   mcopt::OptionType::Call)
+                              .price;
+        EXPECT_NEAR(values[s], expected, 1e-9);
+    }
+
+    engine.setNumThreads(3);
+    engine.setTileSize(7, 2);
+    auto tiled = engine.portfolioValues(portfolio, scenarios);
+    for (std::size_t s = 0; s < scenarios.size(); ++s) {
+        EXPECT_NEAR(tiled[s], values[s], 1e-12);
+    }
+}
+
+// Тест 3: VaR и ES на известном распределении P&L (длинная позиция в форварде через паритет)
+TEST(RiskEngineTest, VarAndExpectedShortfall) {
+    mcopt::MarketState base{100.0, 0.0, 0.2};
+    // Long call + short put с одинаковым страйком = форвард: P&L линеен по споту
+    std::vector<mcopt::Position> portfolio = {
+        {std::make_shared<mcopt::PayoffCall>(100.0), 1.0, 1.0},
+        {std::make_shared<mcopt::PayoffPut>(100.0), -1.0, 1.0},
+    };
+    std::vector<mcopt::MarketScenario> scenarios;
+    for (int i = 1; i <= 100; ++i) {
+        scenarios.push_back({-0.01 * i + 0.5, 0.0, 0.0});  // Сдвиги спота от +49% до -50%
+    }
+
+    mcopt::ScenarioEngine engine(base);
+    auto report = engine.run(portfolio, scenarios, 0.95, 0.0);
+
+    ASSERT_EQ(report.pnl.size(), scenarios.size());
+    EXPECT_NEAR(report.baseValue, 0.0, 1e-9);
+    // Убытки 1..50 по 100 * 1%: квантиль 95% = 45, хвост = среднее(45..50)
+    EXPECT_NEAR(report.valueAtRisk, 45.0, 1e-9);
+    EXPECT_NEAR(report.expectedShortfall, 47.5, 1e-9);
+    EXPECT_GE(report.expectedShortfall, report.valueAtRisk);
+
+    EXPECT_THROW((void)engine.run(portfolio, {}, 0.99), std::invalid_argument);
+    EXPECT_THROW((void)engine.run(portfolio, scenarios, 1.0), std::invalid_argument);
+}
+
+// Тест 4: Экзотика через MC с общими случайными числами и исторические сценарии
+TEST(RiskEngineTest, ExoticPositionsAndHistoricalScenarios) {
+    mcopt::MarketState base{100.0, 0.05, 0.2};
+    std::vector<mcopt::MarketState> history = {
+        {100.0, 0.05, 0.2}, {98.0, 0.05, 0.22}, {101.0, 0.049, 0.21}, {101.0, 0.05, 0.2}};
+    auto scenarios = mcopt::ScenarioEngine::historicalScenarios(history);
+    ASSERT_EQ(scenarios.size(), 3U);
+    EXPECT_NEAR(scenarios[0].spotShock, -0.02, 1e-12);
+    EXPECT_NEAR(scenarios[1].volShock, -0.01, 1e-12);
+
+    std::vector<mcopt::Position> portfolio = {
+        {std::make_shared<mcopt::PayoffAsianCall>(100.0), 2.0, 1.0}};
+    mcopt::ScenarioEngine engine(base, 4'000, 12);
+    auto report = engine.run(portfolio, scenarios, 0.9);
+
+    // Падение спота уменьшает стоимость азиатского колла, рост — увеличивает;
+    // в последнем сценарии спот не меняется, а волатильность падает (вега > 0)
+    EXPECT_LT(report.pnl[0], 0.0);
+    EXPECT_GT(report.pnl[1], 0.0);
+    EXPECT_LT(report.pnl[2], 0.0);
+    EXPECT_GT(report.pnl[2], report.pnl[0]);
+
+    // Детерминизм
+    auto again = engine.run(portfolio, scenarios, 0.9);
+    EXPECT_EQ(again.pnl, report.pnl);
+}
+
+// Тест 5: Наследник колла со своей выплатой переоценивается через MC, а не аналитикой
+TEST(RiskEngineTest, DerivedVanillaUsesMonteCarlo) {
+    mcopt::MarketState base{100.0, 0.03, 0.2};
+    auto capped = std::make_shared<CappedCall>(100.0);
+    std::vector<mcopt::Position> portfolio = {{capped, 1.0, 1.0}};
+    auto scenarios = mcopt::ScenarioEngine::monteCarloScenarios(base, 5, 0.5, 0.01, 7);
+
+    mcopt::ScenarioEngine engine(base, 8'000);
+    auto values = engine.portfolioValues(portfolio, scenarios);
+    auto report = engine.run(portfolio, scenarios, 0.8);
+    for (std::size_t s = 0; s < scenarios.size(); ++s) {
+        double spot = base.spot * (1.0 + scenarios[s].spotShock);
+        double rate = base.rate + scenarios[s].rateShock;
+        double vol = base.vol + scenarios[s].volShock;
+        mcopt::MonteCarloEngine mc(capped, spot, 1.0, rate, vol, 42);
+        mc.setNumThreads(1);
+        EXPECT_NEAR(values[s], mc.calculatePrice(8'000), 1e-12);
+        EXPECT_LT(values[s], 10.0);
+    }
+    EXPECT_GT(report.valueAtRisk, 0.0);
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/RandomStream.hpp"
+#include "../src/Sharding.hpp"
+
+#if MCOPT_HAS_SOCKETS
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// Завершает и дожидается воркеров при любом выходе из теста, в том числе по ASSERT или исключению
+struct WorkerProcesses {
+    std::vector<pid_t> pids;
+
+    ~WorkerProcesses() {
+        for (pid_t pid : pids) {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+};
+
+// Соединение с воркером на loopback: отправляет данные и читает ответ до EOF
+std::string exchange(uint16_t port, const std::string& request, bool closeWrite) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0) close(fd);
+        return "";
+    }
+    (void)!send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    if (closeWrite) shutdown(fd, SHUT_WR);
+    std::string response;
+    char buffer[4096];
+    for (ssize_t n; (n = recv(fd, buffer, sizeof(buffer), 0)) > 0;) {
+        response.append(buffer, static_cast<std::size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+// Воркер в дочернем процессе; возвращает его порт
+uint16_t startWorker(WorkerProcesses& children, std::chrono::milliseconds receiveTimeout) {
+    int fds[2];
+    if (pipe(fds) != 0) return 0;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        mcopt::ShardWorkerServer server(0, 1);
+        server.setReceiveTimeout(receiveTimeout);
+        uint16_t port = server.port();
+        (void)!write(fds[1], &port, sizeof(port));
+        close(fds[1]);
+        server.serve();
+        _exit(0);
+    }
+    close(fds[1]);
+    uint16_t port = 0;
+    if (pid > 0) {
+        children.pids.push_back(pid);
+        if (read(fds[0], &port, sizeof(port)) != static_cast<ssize_t>(sizeof(port))) port = 0;
+    }
+    close(fds[0]);
+    return port;
+}
+
+}  // namespace
+#endif
+
+namespace {
+
+// Транспорт с двумя слотами, считающий одновременно отправленные и еще не готовые шарды
+class CountingTransport : public mcopt::ShardTransport {
+   public:
+    std::future<mcopt::ShardResult> submit(const mcopt::ShardTask& task) override {
+        const std::size_t now = ++m_active;
+        std::size_t peak = m_peak.load();
+        while (now > peak && !m_peak.compare_exchange_weak(peak, now)) {
+        }
+        return std::async(std::launch::async, [this, task]() {
+            mcopt::ShardResult result = mcopt::runShard(task, 1);
+            --m_active;
+            return result;
+        });
+    }
+    std::size_t concurrency() const noexcept override { return 2; }
+    std::size_t peak() const noexcept { return m_peak.load(); }
+
+   private:
+    std::atomic<std::size_t> m_active{0};
+    std::atomic<std::size_t> m_peak{0};
+};
+
+}  // namespace
+
+// Проверка детерминированного шардирования
+
+static mcopt::PricingJob makeJob(const std::string& payoff, unsigned int steps) {
+    // Нечетное число путей, не кратное размеру блока: последний блок неполный
+    return {payoff, 100.0, 100.0, 1.0, 0.05, 0.2, 2024, 5 * mcopt::PATHS_PER_BLOCK + 3, steps};
+}
+
+// Тест 1: Цена не зависит от числа потоков
+TEST(ShardingTest, ThreadCountInvariance) {
+    auto payoff = std::make_shared<mcopt::PayoffCall>(100.0);
+    mcopt::MonteCarloEngine engine(payoff, 100.0, 1.0, 0.05, 0.2, 99);
+
+    engine.setNumThreads(1);
+    double price1 = engine.calculatePrice(200'001);
+    engine.setNumThreads(3);
+    double price3 = engine.calculatePrice(200'001);
+
+    EXPECT_EQ(price1, price3);
+}
+
+// Тест 2: Шардированный расчет побитово совпадает с однопроцессным (European и Asian)
+TEST(ShardingTest, LocalShardsMatchSingleProcess) {
+    auto transport = std::make_shared<mcopt::LocalTransport>(2);
+
+    auto european = makeJob("Call", 0);
+    double single = european.makeEngine().calculatePrice(european.numSimulations);
+    for (unsigned long long shardSize : {1ULL, 2ULL, 4ULL, 100ULL}) {
+        mcopt::ShardCoordinator coordinator(transport, shardSize);
+        auto result = coordinator.price(european);
+        EXPECT_EQ(result.price, single) << "blocksPerShard = " << shardSize;
+        EXPECT_GT(result.standardError, 0.0);
+    }
+
+    auto asian = makeJob("Asian Call", 12);
+    double singleAsian = asian.makeEngine().calculateAsianPrice(asian.numSimulations, 12);
+    mcopt::ShardCoordinator coordinator(transport, 2);
+    EXPECT_EQ(coordinator.price(asian).price, singleAsian);
+}
+
+// Тест 3: Число одновременно отправленных шардов ограничено окном по слотам транспорта
+TEST(ShardingTest, InFlightWindowIsBounded) {
+    auto transport = std::make_shared<CountingTransport>();
+    auto job = makeJob("Call", 0);
+    job.numSimulations = 20 * mcopt::PATHS_PER_BLOCK + 1;
+    double single = job.makeEngine().calculatePrice(job.numSimulations);
+
+    mcopt::ShardCoordinator coordinator(transport, 1);
+    EXPECT_EQ(coordinator.price(job).price, single);
+    EXPECT_GE(transport->peak(), 1U);
+    EXPECT_LE(transport->peak(), mcopt::SHARDS_IN_FLIGHT_PER_SLOT * transport->concurrency());
+}
+
+// Тест 4: Кодек задач и результатов сохраняет значения побитово
+TEST(ShardingTest, SerializationRoundTrip) {
+    mcopt::ShardTask task{makeJob("Asian Call", 7), 3, 5};
+    task.job.sigma = 0.1 + 0.2;  // Значение без точного десятичного представления
+    auto decoded = mcopt::deserializeTask(mcopt::serializeTask(task));
+    EXPECT_EQ(decoded.job.payoff, "Asian Call");
+    EXPECT_EQ(decoded.job.sigma, task.job.sigma);
+    EXPECT_EQ(decoded.firstBlock, 3U);
+    EXPECT_EQ(decoded.lastBlock, 5U);
+    EXPECT_EQ(decoded.job.numSteps, 7U);
+
+    EXPECT_THROW((void)mcopt::deserializeTask("garbage"), std::runtime_error);
+
+    // Пустой, перевернутый или выходящий за задание диапазон блоков отклоняется
+    for (auto [first, last] : {std::pair{4ULL, 4ULL}, std::pair{5ULL, 2ULL},
+                               std::pair{0ULL, 7ULL}, std::pair{6ULL, 7ULL}}) {
+        mcopt::ShardTask bad{makeJob("Call", 0), first, last};  // 6 блоков
+        EXPECT_THROW((void)mcopt::deserializeTask(mcopt::serializeTask(bad)),
+                     std::invalid_argument)
+            << first << ".." << last;
+    }
+    mcopt::ShardTask whole{makeJob("Call", 0), 0, 6};
+    EXPECT_NO_THROW((void)mcopt::deserializeTask(mcopt::serializeTask(whole)));
+    EXPECT_THROW((void)mcopt::deserializeResult("ERROR boom\n"), std::runtime_error);
+}
+
+// Тест 5: Несколько процессов-воркеров через TCP на одной машине
+TEST(ShardingTest, SocketWorkersMatchSingleProcess) {
+#if MCOPT_HAS_SOCKETS
+    WorkerProcesses children;
+    std::vector<mcopt::WorkerEndpoint> endpoints;
+
+    for (int w = 0; w < 3; ++w) {
+        uint16_t port = startWorker(children, std::chrono::seconds(30));
+        ASSERT_NE(port, 0);
+        endpoints.push_back({"127.0.0.1", port});
+    }
+
+    auto job = makeJob("Put", 0);
+    double single = job.makeEngine().calculatePrice(job.numSimulations);
+
+    mcopt::ShardCoordinator coordinator(std::make_shared<mcopt::SocketTransport>(endpoints), 1);
+    auto result = coordinator.price(job);
+
+    EXPECT_EQ(result.price, single);
+    EXPECT_EQ(result.paths, job.numSimulations);
+
+    // Воркеры слушают только loopback; адрес интерфейса проверяется
+    EXPECT_THROW(mcopt::ShardWorkerServer(0, 1, "localhost:80"), std::invalid_argument);
+#else
+    GTEST_SKIP() << "Sockets are not available on this platform.";
+#endif
+}
+
+// Тест 6: Зависший или слишком длинный запрос завершает соединение, а не блокирует воркер
+TEST(ShardingTest, WorkerRejectsStalledAndOversizedRequests) {
+#if MCOPT_HAS_SOCKETS
+    WorkerProcesses children;
+    uint16_t port = startWorker(children, std::chrono::milliseconds(200));
+    ASSERT_NE(port, 0);
+
+    // Клиент не закрывает запись: ответ об ошибке по таймауту
+    EXPECT_EQ(exchange(port, "TASK 0", false).rfind("ERROR", 0), 0U);
+    // Поток без конца: соединение обрывается после MAX_TASK_BYTES
+    std::string flood(4 * mcopt::MAX_TASK_BYTES, 'x');
+    std::string reply = exchange(port, flood, true);
+    EXPECT_TRUE(reply.empty() || reply.rfind("ERROR", 0) == 0) << reply;
+
+    // Воркер продолжает обслуживать обычные задачи
+    auto job = makeJob("Call", 0);
+    mcopt::ShardTask task{job, 0, 2};
+    auto result = mcopt::deserializeResult(exchange(port, mcopt::serializeTask(task), true));
+    EXPECT_EQ(result.blocks.size(), 2U);
+    EXPECT_THROW(mcopt::ShardWorkerServer(0, 1).setReceiveTimeout(std::chrono::milliseconds(0)),
+                 std::invalid_argument);
+#else
+    GTEST_SKIP() << "Sockets are not available on this platform.";
+#endif
+}
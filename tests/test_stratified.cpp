@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../src/Analytical.hpp"
+#include "../src/BrownianBridge.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double K = 100.0;
+const double T = 1.0;
+const double r = 0.05;
+const double sigma = 0.2;
+
+}  // namespace
+
+// Тест 1: Мост дает ковариацию броуновского движения min(t_i, t_j)
+TEST(StratifiedSamplingTest, BrownianBridgeCovariance) {
+    const std::size_t n = 10;  // Не степень двойки
+    mcopt::BrownianBridge bridge(n);
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> dist(0.0, 1.0);
+
+    const int samples = 200'000;
+    std::vector<double> z(n), w(n);
+    double var9 = 0.0, var2 = 0.0, cov29 = 0.0, cov47 = 0.0;
+    for (int s = 0; s < samples; ++s) {
+        for (double& x : z) x = dist(rng);
+        bridge.buildPath(z.data(), w.data());
+        var9 += w[9] * w[9];
+        var2 += w[2] * w[2];
+        cov29 += w[2] * w[9];
+        cov47 += w[4] * w[7];
+    }
+    EXPECT_NEAR(var9 / samples, 10.0, 0.15);
+    EXPECT_NEAR(var2 / samples, 3.0, 0.05);
+    EXPECT_NEAR(cov29 / samples, 3.0, 0.06);
+    EXPECT_NEAR(cov47 / samples, 5.0, 0.08);
+
+    // Первая переменная задает конец пути
+    std::fill(z.begin(), z.end(), 0.0);
+    z[0] = 1.0;
+    bridge.buildPath(z.data(), w.data());
+    EXPECT_NEAR(w[9], std::sqrt(10.0), 1e-12);
+    EXPECT_NEAR(w[4], 0.5 * std::sqrt(10.0), 1e-12);
+}
+
+// Тест 2: Европейский опцион — стратификация и LHS сильно снижают ошибку
+TEST(StratifiedSamplingTest, EuropeanVarianceReduction) {
+    auto exact =
+        mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, sigma, mcopt::OptionType::Call);
+    auto payoff = std::make_shared<mcopt::PayoffCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, 42);
+    const unsigned long long paths = 200'000;
+
+    double plainSE = engine.calculateSpotLadder({S0}, paths).front().standardError;
+
+    mcopt::PricingResult proportional = engine.calculateStratifiedPrice(paths, 0, 64);
+    EXPECT_EQ(proportional.paths, paths);
+    EXPECT_NEAR(proportional.price, exact.price, 4.0 * proportional.standardError);
+    EXPECT_LT(proportional.standardError, 0.2 * plainSE);
+
+    mcopt::PricingResult neyman =
+        engine.calculateStratifiedPrice(paths, 0, 64, mcopt::Allocation::Neyman);
+    EXPECT_NEAR(neyman.price, exact.price, 4.0 * neyman.standardError);
+    EXPECT_LT(neyman.standardError, proportional.standardError);
+
+    mcopt::PricingResult lhs = engine.calculateLatinHypercubePrice(paths, 0);
+    EXPECT_NEAR(lhs.price, exact.price, 4.0 * lhs.standardError + 1e-3);
+    EXPECT_LT(lhs.standardError, 0.2 * plainSE);
+
+    // Результат не зависит от числа потоков
+    engine.setNumThreads(1);
+    EXPECT_EQ(engine.calculateStratifiedPrice(paths, 0, 64).price, proportional.price);
+    EXPECT_EQ(engine.calculateLatinHypercubePrice(paths, 0).price, lhs.price);
+
+    EXPECT_THROW((void)engine.calculateStratifiedPrice(100, 0, 64), std::invalid_argument);
+    EXPECT_THROW((void)engine.calculateLatinHypercubePrice(paths, 0, 0), std::invalid_argument);
+    EXPECT_THROW((void)engine.calculateLatinHypercubePrice(paths, 0, 1, 1), std::invalid_argument);
+}
+
+// Тест 3: Азиатский опцион — стратификация первых измерений моста
+TEST(StratifiedSamplingTest, AsianBrownianBridgeDimensions) {
+    auto payoff = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine engine(payoff, S0, T, r, sigma, 42);
+    const unsigned long long paths = 100'000;
+    const unsigned int steps = 32;
+
+    mcopt::PricingResult plain = engine.calculateAsianPriceAsync(paths, steps).get();
+    mcopt::PricingResult stratified = engine.calculateStratifiedPrice(paths, steps, 64);
+    mcopt::PricingResult lhs = engine.calculateLatinHypercubePrice(paths, steps, 4);
+
+    double tolerance = 4.0 * std::hypot(plain.standardError, stratified.standardError);
+    EXPECT_NEAR(stratified.price, plain.price, tolerance);
+    EXPECT_NEAR(lhs.price, plain.price, 4.0 * std::hypot(plain.standardError, lhs.standardError));
+    EXPECT_LT(stratified.standardError, 0.6 * plain.standardError);
+    EXPECT_LT(lhs.standardError, 0.6 * plain.standardError);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/Analytical.hpp"
+#include "../src/MCEngine.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/TermStructure.hpp"
+
+namespace {
+
+const double S0 = 100.0;
+const double K = 100.0;
+const double T = 1.0;
+const double r = 0.05;
+const double sigma = 0.2;
+
+}  // namespace
+
+// Тест 1: Интегралы кусочно-постоянной кривой и проверка постоянства на отрезке
+TEST(TermStructureTest, CurveIntegrals) {
+    mcopt::PiecewiseConstantCurve curve({0.25, 0.75}, {0.1, 0.2, 0.3});
+    EXPECT_DOUBLE_EQ(curve.value(0.1), 0.1);
+    EXPECT_DOUBLE_EQ(curve.value(0.25), 0.1);
+    EXPECT_DOUBLE_EQ(curve.value(0.5), 0.2);
+    EXPECT_DOUBLE_EQ(curve.value(2.0), 0.3);
+    EXPECT_NEAR(curve.integral(0.0, 1.0), 0.025 + 0.1 + 0.075, 1e-15);
+    EXPECT_NEAR(curve.squareIntegral(0.5, 1.0), 0.04 * 0.25 + 0.09 * 0.25, 1e-15);
+
+    double v = 0.0;
+    EXPECT_TRUE(curve.constantOn(0.25, 0.75, v));
+    EXPECT_DOUBLE_EQ(v, 0.2);
+    EXPECT_FALSE(curve.constantOn(0.2, 0.3, v));
+
+    EXPECT_THROW(mcopt::PiecewiseConstantCurve({0.5, 0.5}, {0.1, 0.2, 0.3}),
+                 std::invalid_argument);
+    EXPECT_THROW(mcopt::PiecewiseConstantCurve({0.5}, {0.1}), std::invalid_argument);
+}
+
+// Тест 2: Европейский опцион с кривыми и дивидендами против формулы с интегральными параметрами
+TEST(TermStructureTest, EuropeanMatchesIntegratedBlackScholes) {
+    auto call = std::make_shared<mcopt::PayoffCall>(K);
+    mcopt::MonteCarloEngine engine(call, S0, T, r, sigma);
+    mcopt::PiecewiseConstantCurve rates({0.5}, {0.02, 0.06});
+    mcopt::PiecewiseConstantCurve vols({0.25, 0.5}, {0.35, 0.15, 0.25});
+    engine.setRateCurve(rates);
+    engine.setVolCurve(vols);
+    engine.setDividends({{0.3, 2.0, mcopt::DividendType::Cash},
+                         {0.8, 0.03, mcopt::DividendType::Proportional},
+                         {1.5, 5.0, mcopt::DividendType::Cash}});  // После погашения
+
+    double pvCash = 2.0 * std::exp(-rates.integral(0.0, 0.3));
+    double adjustedSpot = (S0 - pvCash) * (1.0 - 0.03);
+    auto exact = mcopt::BlackScholesAnalytical::calculateIntegrated(
+        adjustedSpot, K, rates.integral(0.0, T), vols.squareIntegral(0.0, T),
+        mcopt::OptionType::Call);
+
+    auto result = engine.calculateSpotLadder({S0}, 400'000)[0];
+    EXPECT_NEAR(result.price, exact.price, 4.0 * result.standardError);
+    EXPECT_DOUBLE_EQ(engine.calculatePrice(400'000), result.price);
+
+    // Плоские параметры: формула совпадает с обычной Блэком-Шоулзом
+    auto flat = mcopt::BlackScholesAnalytical::calculateIntegrated(S0, K, r * T, sigma * sigma * T,
+                                                                   mcopt::OptionType::Put);
+    auto bs = mcopt::BlackScholesAnalytical::calculate(S0, K, T, r, sigma, mcopt::OptionType::Put);
+    EXPECT_NEAR(flat.price, bs.price, 1e-12);
+    EXPECT_NEAR(flat.delta, bs.delta, 1e-12);
+    EXPECT_NEAR(flat.gamma, bs.gamma, 1e-12);
+}
+
+// Тест 3: Кривые с одинаковыми значениями по обе стороны узла дают ту же цену, что и константы
+TEST(TermStructureTest, SplitFlatCurvesMatchConstants) {
+    auto call = std::make_shared<mcopt::PayoffCall>(K);
+    auto asian = std::make_shared<mcopt::PayoffAsianCall>(K);
+    mcopt::MonteCarloEngine flatEuro(call, S0, T, r, sigma);
+    mcopt::MonteCarloEngine flatAsian(asian, S0, T, r, sigma);
+    mcopt::MonteCarloEngine splitEuro(call, S0, T, r, sigma);
+    mcopt::MonteCarloEngine splitAsian(asian, S0, T, r, sigma);
+    for (auto* engine : {&splitEuro, &splitAsian}) {
+        engine->setRateCurve(mcopt::PiecewiseConstantCurve({0.37}, {r, r}));
+        engine->setVolCurve(mcopt::PiecewiseConstantCurve({0.37}, {sigma, sigma}));
+    }
+
+    const unsigned long long n = 50'000;
+    EXPECT_NEAR(splitEuro.calculatePrice(n), flatEuro.calculatePrice(n), 1e-10);
+    EXPECT_NEAR(splitAsian.calculateAsianPrice(n, 12), flatAsian.calculateAsianPrice(n, 12),
+                1e-10);
+
+    // Денежный дивиденд снижает цену азиатского колла
+    splitAsian.setDividends({{0.5, 3.0, mcopt::DividendType::Cash}});
+    EXPECT_LT(splitAsian.calculateAsianPrice(n, 12), flatAsian.calculateAsianPrice(n, 12) - 0.5);
+
+    // Методы, предполагающие постоянные параметры, отказываются работать
+    EXPECT_THROW(static_cast<void>(splitAsian.calculateAsianSensitivities(n, 12)),
+                 std::logic_error);
+    EXPECT_THROW(static_cast<void>(splitEuro.calculatePriceIS(n)), std::logic_error);
+    EXPECT_THROW(splitEuro.setDividends({{0.5, 1.5, mcopt::DividendType::Proportional}}),
+                 std::invalid_argument);
+}
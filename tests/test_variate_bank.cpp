@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/MCEngine.hpp"
+#include "../src/NormalGenerator.hpp"
+#include "../src/Payoff.hpp"
+#include "../src/RandomStream.hpp"
+#include "../src/VariateBank.hpp"
+
+namespace {
+
+std::string bankPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}  // namespace
+
+// Тест 1: Банк хранит живой поток блоков; расчеты с банком совпадают побитово
+TEST(VariateBankTest, BankMatchesLiveGeneration) {
+    const std::string path = bankPath("mcopt_bank_test.bin");
+    const unsigned long long paths = 3 * mcopt::PATHS_PER_BLOCK + 101;  // Неполный блок, нечетное
+    mcopt::VariateBank::create(path, 7, mcopt::NormalMethod::Ziggurat, paths, 12);
+    auto bank = std::make_shared<const mcopt::VariateBank>(path);
+    EXPECT_EQ(bank->blocks(), 4u);
+    EXPECT_EQ(bank->variatesPerBlock(), mcopt::PATHS_PER_BLOCK * 12);
+
+    std::vector<double> live(16);
+    std::mt19937_64 rng = mcopt::makeStreamRng(7, mcopt::STREAM_PATH_BLOCKS, 2);
+    mcopt::NormalGenerator().fill(rng, live.data(), live.size());
+    const double* mapped = bank->stream(7, mcopt::NormalMethod::Ziggurat, 2, live.size());
+    ASSERT_NE(mapped, nullptr);
+    for (std::size_t i = 0; i < live.size(); ++i) EXPECT_EQ(mapped[i], live[i]);
+
+    // Один банк на несколько движков, потоков и точностей
+    auto call = std::make_shared<mcopt::PayoffCall>(105.0);
+    auto asian = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine european(call, 100.0, 1.0, 0.05, 0.2, 7);
+    mcopt::MonteCarloEngine averaging(asian, 100.0, 1.0, 0.05, 0.2, 7);
+    european.setNumThreads(3);
+    for (auto precision : {mcopt::Precision::Double, mcopt::Precision::Single}) {
+        european.setPrecision(precision);
+        averaging.setPrecision(precision);
+        european.setVariateBank(nullptr);
+        averaging.setVariateBank(nullptr);
+        auto liveEuropean = european.calculatePrice(paths);
+        auto liveAsian = averaging.calculateAsianPrice(paths, 12);
+        auto liveLadder = european.calculateSpotLadder({95.0, 110.0}, paths);
+        european.setVariateBank(bank);
+        averaging.setVariateBank(bank);
+        EXPECT_EQ(european.calculatePrice(paths), liveEuropean);
+        EXPECT_EQ(european.calculateSpotLadder({95.0, 110.0}, paths)[1].price,
+                  liveLadder[1].price);
+        EXPECT_EQ(averaging.calculateAsianPrice(paths, 12), liveAsian);
+    }
+
+    bank.reset();
+    std::remove(path.c_str());
+}
+
+// Тест 2: Непокрытые блоки (другой seed, больше путей или шагов) считаются живым генератором
+TEST(VariateBankTest, FallbackToLiveGeneration) {
+    const std::string path = bankPath("mcopt_bank_small.bin");
+    mcopt::VariateBank::create(path, 7, mcopt::NormalMethod::Ziggurat, 20'000);
+    auto bank = std::make_shared<const mcopt::VariateBank>(path);
+    EXPECT_EQ(bank->stream(8, mcopt::NormalMethod::Ziggurat, 0, 1), nullptr);
+    EXPECT_EQ(bank->stream(7, mcopt::NormalMethod::InverseCdf, 0, 1), nullptr);
+    EXPECT_EQ(bank->stream(7, mcopt::NormalMethod::Ziggurat, 2, 1), nullptr);
+    EXPECT_EQ(bank->stream(7, mcopt::NormalMethod::Ziggurat, 0, bank->variatesPerBlock() + 1),
+              nullptr);
+
+    auto call = std::make_shared<mcopt::PayoffCall>(100.0);
+    auto asian = std::make_shared<mcopt::PayoffAsianCall>(100.0);
+    mcopt::MonteCarloEngine european(call, 100.0, 1.0, 0.05, 0.2, 7);
+    mcopt::MonteCarloEngine averaging(asian, 100.0, 1.0, 0.05, 0.2, 7);
+    auto liveEuropean = european.calculatePrice(100'000);
+    auto liveAsian = averaging.calculateAsianPrice(20'000, 8);
+    european.setVariateBank(bank);
+    averaging.setVariateBank(bank);
+    EXPECT_EQ(european.calculatePrice(100'000), liveEuropean);  // Блоки 0-1 из банка, 2-6 живые
+    EXPECT_EQ(averaging.calculateAsianPrice(20'000, 8), liveAsian);  // Банк только европейский
+
+    // Движок читает отображение на месте: обнуленный в файле блок меняет цену
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        std::vector<double> zeros(bank->variatesPerBlock(), 0.0);
+        file.seekp(64);
+        file.write(reinterpret_cast<const char*>(zeros.data()),
+                   static_cast<std::streamsize>(zeros.size() * sizeof(double)));
+    }
+    EXPECT_NE(european.calculatePrice(100'000), liveEuropean);
+
+    // Поврежденный файл и пустой банк отклоняются
+    { std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a bank"; }
+    EXPECT_THROW(mcopt::VariateBank{path}, std::runtime_error);
+    EXPECT_THROW(mcopt::VariateBank::create(path, 7, mcopt::NormalMethod::Ziggurat, 0),
+                 std::invalid_argument);
+    std::remove(path.c_str());
+}